@@ -243,6 +243,46 @@ typedef struct
                                    modified by the caller. */
 } Endpoint_Info_t;
 
+/**
+ * \brief The stages of a message exchange reported to the callback set with
+ *        \ref protocol_set_callback_stage.
+ */
+typedef enum
+{
+    PROTOCOL_STAGE_SEND_AND_RECEIVE = 0, /**< A request to the device
+                                              including all responses. */
+    PROTOCOL_STAGE_GET_MESSAGE      = 1, /**< The reception of a single
+                                              message from the COM port. */
+    PROTOCOL_STAGE_PARSE_PAYLOAD    = 2  /**< The parsing of a payload message
+                                              by its endpoint, including the
+                                              endpoint callbacks. */
+} Protocol_Stage_t;
+
+/**
+ * \brief This structure holds statistics of the received data of all
+ *        connections.
+ */
+typedef struct
+{
+    uint64_t received_bytes;  /**< The number of bytes received from COM
+                                   ports. */
+    uint32_t resyncs;         /**< The number of times received data was
+                                   discarded to get in sync with the message
+                                   stream again. */
+} Protocol_Statistics_t;
+
+/**
+ * \brief Definition of the callback function for instrumentation of the
+ *        message exchange.
+ *
+ * The callback is called with begin = 1 when a stage is entered and with
+ * begin = 0 when it is left. It is called from the thread performing the
+ * message exchange and should return quickly.
+ */
+typedef void(*Callback_Protocol_Stage_t)(void* context,
+                                         Protocol_Stage_t stage,
+                                         uint8_t begin);
+
 /*
 ==============================================================================
    5. FUNCTION PROTOTYPES AND INLINE FUNCTIONS
@@ -398,6 +438,32 @@ int32_t protocol_get_endpoint_info(int32_t protocol_handle, uint8_t endpoint,
 const char* protocol_get_status_code_description(int32_t protocol_handle,
                                                  int32_t status_code);
 
+/**
+ * \brief This function sets the callback function for instrumentation of
+ *        the message exchange.
+ *
+ * The callback is optional and disabled by passing NULL. It applies to all
+ * connections.
+ *
+ * \param[in] callback  The function to be called when a stage of the message
+ *                      exchange is entered or left.
+ * \param[in] context   A data pointer that is forwarded to the callback
+ *                      function.
+ */
+void protocol_set_callback_stage(Callback_Protocol_Stage_t callback,
+                                 void* context);
+
+/**
+ * \brief This function returns the statistics of the received data.
+ *
+ * The statistics are not synchronized, so this function should be called
+ * from the thread performing the message exchange.
+ *
+ * \param[out] statistics  A pointer to the structure that is filled with the
+ *                         statistics.
+ */
+void protocol_get_statistics(Protocol_Statistics_t* statistics);
+
 /* --- Close open blocks -------------------------------------------------- */
 
 /* Disable C linkage for C++ files */
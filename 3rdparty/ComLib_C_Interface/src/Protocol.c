@@ -199,6 +199,19 @@ static size_t num_open_handles = 0;       /**< The current number of open
 
 /** @} */
 
+/**
+ * \internal
+ * \brief The optional instrumentation callback and its context data pointer.
+ */
+static Callback_Protocol_Stage_t callback_stage = NULL;
+static void* context_stage = NULL;
+
+/**
+ * \internal
+ * \brief The statistics of the received data of all connections.
+ */
+static Protocol_Statistics_t statistics = {0, 0};
+
 /* Include list of known endpoints (see Protocol_KnownEndpoints.h for details)
  */
 #define __PROTOCOL_INCLUDES_ENDPOINT_LIST__
@@ -239,6 +252,21 @@ static size_t num_open_handles = 0;       /**< The current number of open
  */
 static void recover_from_receive_error(int32_t com_port_handle);
 
+/**
+ * \internal
+ * \brief This function forwards a stage of the message exchange to the
+ *        instrumentation callback, if there is one.
+ */
+static void report_stage(Protocol_Stage_t stage, uint8_t begin);
+
+/**
+ * \internal
+ * \brief This function reads data from a COM port like \ref com_get_data
+ *        and counts the received bytes.
+ */
+static size_t receive_data(int32_t com_port_handle, void* data,
+                           size_t num_requested_bytes);
+
 /**
  * \internal
  * \brief This function sends a payload message to an endpoint of a connected
@@ -305,15 +333,34 @@ static int32_t get_message(int32_t com_port_handle,
 
 ///@endcond
 
+static void report_stage(Protocol_Stage_t stage, uint8_t begin)
+{
+    if (callback_stage)
+    {
+        callback_stage(context_stage, stage, begin);
+    }
+}
+
+static size_t receive_data(int32_t com_port_handle, void* data,
+                           size_t num_requested_bytes)
+{
+    size_t num_received_bytes = com_get_data(com_port_handle, data,
+                                             num_requested_bytes);
+    statistics.received_bytes += num_received_bytes;
+    return num_received_bytes;
+}
+
 static void recover_from_receive_error(int32_t com_port_handle)
 {
     /* read until buffer is empty */
     uint8_t dummy_data[1024];
     size_t received_bytes = sizeof(dummy_data);
 
+    ++statistics.resyncs;
+
     while (received_bytes == sizeof(dummy_data))
     {
-        received_bytes = com_get_data(com_port_handle,
+        received_bytes = receive_data(com_port_handle,
                                       dummy_data, sizeof(dummy_data));
     }
 
@@ -349,7 +396,7 @@ static int32_t get_message(int32_t com_port_handle,
 
     /* read message header */
     /* ------------------- */
-    num_received_bytes = com_get_data(com_port_handle,
+    num_received_bytes = receive_data(com_port_handle,
                                       message_header, sizeof(message_header));
 
     /*
@@ -360,7 +407,7 @@ static int32_t get_message(int32_t com_port_handle,
      */
     if ((num_received_bytes < sizeof(message_header)))
     {
-        num_received_bytes += com_get_data(com_port_handle,
+        num_received_bytes += receive_data(com_port_handle,
                                            message_header +
                                              num_received_bytes,
                                            sizeof(message_header) -
@@ -397,7 +444,7 @@ static int32_t get_message(int32_t com_port_handle,
                       ((uint16_t)message_header[3]) << 8;
         payload = (uint8_t*)malloc(payload_size);
 
-        num_received_bytes = com_get_data(com_port_handle,
+        num_received_bytes = receive_data(com_port_handle,
                                           payload, payload_size);
 
         /* check if payload has been received completely */
@@ -412,7 +459,7 @@ static int32_t get_message(int32_t com_port_handle,
         }
 
         /* check message tail */
-        num_received_bytes = com_get_data(com_port_handle, &message_tail,
+        num_received_bytes = receive_data(com_port_handle, &message_tail,
                                           sizeof(message_tail));
 
         if ((num_received_bytes != sizeof(message_tail)) ||
@@ -876,14 +923,23 @@ int32_t protocol_send_and_receive(int32_t protocol_handle,
                                                endpoint_definiton);
     }
 
+    report_stage(PROTOCOL_STAGE_SEND_AND_RECEIVE, 1);
+
     /* send message */
     send_message(protocol->com_port_handle, endpoint, payload, payload_size);
 
     /* receive messages from the board */
-    while ((status_code = get_message(protocol->com_port_handle,
-                                      &message_info)) ==
-             CNST_PROTOCOL_RECEIVED_PAYLOAD_MSG)
+    for (;;)
     {
+        report_stage(PROTOCOL_STAGE_GET_MESSAGE, 1);
+        status_code = get_message(protocol->com_port_handle, &message_info);
+        report_stage(PROTOCOL_STAGE_GET_MESSAGE, 0);
+
+        if (status_code != CNST_PROTOCOL_RECEIVED_PAYLOAD_MSG)
+        {
+            break;
+        }
+
         /* forward message to endpoint implementation */
         if (message_info.endpoint > 0)
         {
@@ -892,19 +948,38 @@ int32_t protocol_send_and_receive(int32_t protocol_handle,
 
             if (endpoint_ptr)
             {
+                report_stage(PROTOCOL_STAGE_PARSE_PAYLOAD, 1);
                 endpoint_ptr->parse_payload(protocol_handle,
                                             message_info.endpoint,
                                             message_info.payload,
                                             message_info.payload_size);
+                report_stage(PROTOCOL_STAGE_PARSE_PAYLOAD, 0);
             }
         }
 
         free(message_info.payload);
     }
 
+    report_stage(PROTOCOL_STAGE_SEND_AND_RECEIVE, 0);
+
     return status_code;
 }
 
+void protocol_set_callback_stage(Callback_Protocol_Stage_t callback,
+                                 void* context)
+{
+    callback_stage = callback;
+    context_stage = context;
+}
+
+void protocol_get_statistics(Protocol_Statistics_t* statistics_ptr)
+{
+    if (statistics_ptr)
+    {
+        *statistics_ptr = statistics;
+    }
+}
+
 
 const char* protocol_get_status_code_description(int32_t protocol_handle,
                                                  int32_t status_code)
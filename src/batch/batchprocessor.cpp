@@ -0,0 +1,186 @@
+#include "batchprocessor.h"
+
+#include <misc/constants.h>
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <memory>
+
+
+struct BatchShard_t
+{
+    BatchResult_t result;
+    QSemaphore done;
+};
+
+static bool sameSettings(SignalProcessorSettings_t const & a, SignalProcessorSettings_t const & b)
+{
+    return a.window == b.window && a.zero_padding_factor == b.zero_padding_factor &&
+           a.persistence_threshold == b.persistence_threshold && a.cfar_guard_cells == b.cfar_guard_cells &&
+           a.cfar_training_cells == b.cfar_training_cells && a.cfar_threshold_factor == b.cfar_threshold_factor;
+}
+
+BatchProcessor::BatchProcessor()
+{
+    m_threads = QThread::idealThreadCount();
+    m_shard_size = BATCH_DEFAULT_SHARD_SIZE;
+}
+
+void BatchProcessor::setThreadCount(int threads)
+{
+    m_threads = threads > 0 ? threads : QThread::idealThreadCount();
+}
+
+void BatchProcessor::setShardSize(size_t frames)
+{
+    m_shard_size = frames > 0 ? frames : BATCH_DEFAULT_SHARD_SIZE;
+}
+
+void BatchProcessor::setSignalProcessorSettings(const SignalProcessorSettings_t &settings)
+{
+    m_settings = settings;
+}
+
+bool BatchProcessor::run(const QString &input, const QString &output)
+{
+    if (!m_reader.open(input))
+        return false;
+
+    // The range axis depends on the zero padding factor
+    ColumnWriter writer;
+    if (!writer.open(output, SignalProcessor(m_settings).rangeVector()))
+        return false;
+
+    auto frames = m_reader.frameCount();
+    auto shards = (frames + m_shard_size - 1) / m_shard_size;
+
+    // Workers run ahead of the writer by a bounded number of shards, results are written in recording order
+    QThreadPool pool;
+    pool.setMaxThreadCount(m_threads);
+
+    auto window = std::min<size_t>(shards, m_threads * BATCH_SHARDS_IN_FLIGHT_PER_THREAD);
+    std::vector<std::unique_ptr<BatchShard_t>> in_flight;
+    for (size_t i = 0; i < window; i++)
+        in_flight.push_back(std::make_unique<BatchShard_t>());
+
+    auto submit = [&](size_t shard)
+    {
+        auto slot = in_flight[shard % window].get();
+        auto first = shard * m_shard_size;
+        auto last = std::min(first + m_shard_size, frames);
+
+        pool.start([this, slot, first, last]()
+        {
+            processShard(first, last, slot->result);
+            slot->done.release();
+        });
+    };
+
+    qInfo() << "Processing" << frames << "frames in" << shards << "shards on" << m_threads << "threads...";
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (size_t shard = 0; shard < window; shard++)
+        submit(shard);
+
+    size_t rows = 0;
+    for (size_t shard = 0; shard < shards; shard++)
+    {
+        auto slot = in_flight[shard % window].get();
+        slot->done.acquire();
+        writer.write(slot->result);
+        rows += slot->result.frame_number.size();
+
+        if (shard + window < shards)
+            submit(shard + window);
+    }
+
+    writer.close();
+    m_reader.close();
+
+    auto elapsed = std::max<qint64>(timer.elapsed(), 1);
+    qInfo() << "Processed" << rows << "frames in" << elapsed << "ms"
+            << "(" << rows * 1000 / elapsed << "frames/s )";
+    if (rows != frames)
+        qWarning() << "Skipped" << frames - rows << "frames without complete chirp data.";
+
+    return true;
+}
+
+void BatchProcessor::processShard(size_t first, size_t last, BatchResult_t &result) const
+{
+    // Vectors are reused across shards, clearing keeps their capacity
+    result.timestamp_ns.clear();
+    result.frame_number.clear();
+    result.max_magnitude.clear();
+    result.range_rx1.clear();
+    result.range_rx2.clear();
+    result.maxima_count.clear();
+    result.targets_count.clear();
+    result.maxima_range.clear();
+    result.maxima_magnitude.clear();
+    result.target_id.clear();
+    result.target_radius.clear();
+    result.target_azimuth.clear();
+    result.target_level.clear();
+    result.target_radial_speed.clear();
+
+    // One processor per pool thread, so its window and FFT plans are only set up once per worker
+    thread_local SignalProcessor signal_processor;
+    thread_local std::vector<float> samples;
+    if (!sameSettings(signal_processor.settings(), m_settings))
+        signal_processor.setSettings(m_settings);
+    Frame_Info_t frame_info;
+    RecordedFrameView_t view;
+
+    for (auto i = first; i < last; i++)
+    {
+        if (!m_reader.frame(i, view))
+            continue;
+
+        m_reader.unpack(view, samples, frame_info);
+
+        auto n = frame_info.num_samples_per_chirp;
+        if (n == 0 || samples.size() < 4 * static_cast<size_t>(n))
+            continue;
+
+        auto data = samples.data();
+        auto rx1 = signal_processor.calculateRangeData(data, data + n, n);
+        auto rx2 = signal_processor.calculateRangeData(data + 2 * n, data + 3 * n, n);
+
+        auto maximum = 0.0;
+        auto maxima = signal_processor.calculateMaxima(rx1, maximum);
+
+        result.timestamp_ns.push_back(view.frame->timestamp_ns);
+        result.frame_number.push_back(view.frame->frame_number);
+        result.max_magnitude.push_back(maximum);
+
+        for (auto const & p : rx1)
+            result.range_rx1.push_back(p.y());
+        for (auto const & p : rx2)
+            result.range_rx2.push_back(p.y());
+
+        result.maxima_count.push_back(maxima.size());
+        for (auto const & p : maxima)
+        {
+            result.maxima_range.push_back(p.x());
+            result.maxima_magnitude.push_back(p.y());
+        }
+
+        result.targets_count.push_back(view.num_targets);
+        for (uint32_t t = 0; t < view.num_targets; t++)
+        {
+            auto const & target = view.targets[t];
+            result.target_id.push_back(target.target_id);
+            result.target_radius.push_back(target.radius);
+            result.target_azimuth.push_back(target.azimuth);
+            result.target_level.push_back(target.level);
+            result.target_radial_speed.push_back(target.radial_speed);
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <batch/columnwriter.h>
+#include <logic/recording/recordingreader.h>
+#include <logic/signalprocessor/signalprocessor.h>
+
+#include <QString>
+
+class BatchProcessor
+{
+public:
+    BatchProcessor();
+
+    void setThreadCount(int threads);
+    void setShardSize(size_t frames);
+    void setSignalProcessorSettings(SignalProcessorSettings_t const & settings);
+    bool run(QString const & input, QString const & output);
+
+private:
+    void processShard(size_t first, size_t last, BatchResult_t & result) const;
+
+private:
+    RecordingReader m_reader;
+    int m_threads;
+    size_t m_shard_size;
+    SignalProcessorSettings_t m_settings;
+};
+
+#endif // BATCHPROCESSOR_H
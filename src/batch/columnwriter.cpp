@@ -0,0 +1,85 @@
+#include "columnwriter.h"
+
+#include <QDebug>
+#include <cstring>
+
+ColumnWriter::ColumnWriter()
+{
+    m_failed = false;
+}
+
+ColumnWriter::~ColumnWriter()
+{
+    close();
+}
+
+bool ColumnWriter::open(const QString &path, const DoubleVec_t &range)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "Error while opening output file:" << path;
+        return false;
+    }
+
+    ColumnFileHeader_t header;
+    memcpy(header.magic, COLUMN_FILE_MAGIC, sizeof(header.magic));
+    header.version = COLUMN_FILE_VERSION;
+    header.num_bins = range.size();
+
+    m_failed = false;
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeColumn(range);
+
+    return !m_failed;
+}
+
+void ColumnWriter::write(const BatchResult_t &result)
+{
+    if (!m_file.isOpen())
+        return;
+
+    ColumnGroupHeader_t header;
+    header.num_rows = result.frame_number.size();
+    header.num_maxima = result.maxima_range.size();
+    header.num_targets = result.target_id.size();
+    header.reserved = 0;
+
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeColumn(result.timestamp_ns);
+    writeColumn(result.frame_number);
+    writeColumn(result.max_magnitude);
+    writeColumn(result.range_rx1);
+    writeColumn(result.range_rx2);
+    writeColumn(result.maxima_count);
+    writeColumn(result.targets_count);
+    writeColumn(result.maxima_range);
+    writeColumn(result.maxima_magnitude);
+    writeColumn(result.target_id);
+    writeColumn(result.target_radius);
+    writeColumn(result.target_azimuth);
+    writeColumn(result.target_level);
+    writeColumn(result.target_radial_speed);
+}
+
+void ColumnWriter::close()
+{
+    if (!m_file.isOpen())
+        return;
+
+    if (m_failed)
+        qWarning() << "Error while writing output file:" << m_file.errorString();
+
+    m_file.close();
+}
+
+template <typename T>
+void ColumnWriter::writeColumn(const std::vector<T> &column)
+{
+    if (column.empty())
+        return;
+
+    auto size = static_cast<qint64>(column.size() * sizeof(T));
+    if (m_file.write(reinterpret_cast<const char*>(column.data()), size) != size)
+        m_failed = true;
+}
@@ -0,0 +1,77 @@
+#ifndef COLUMNWRITER_H
+#define COLUMNWRITER_H
+
+#include <misc/types.h>
+
+#include <QFile>
+#include <cstdint>
+#include <vector>
+
+// Layout of a column file (all fields little endian):
+//
+//   ColumnFileHeader_t, double range_m[num_bins]
+//   Row groups, each consisting of a ColumnGroupHeader_t followed by the columns of BatchResult_t
+//   in declaration order. Per frame columns hold num_rows values, the range spectra num_rows * num_bins,
+//   maxima and target columns the sum of the respective per frame counts.
+
+constexpr char COLUMN_FILE_MAGIC[8] = {'P', '2', 'G', 'C', 'O', 'L', '0', '1'};
+constexpr uint32_t COLUMN_FILE_VERSION = 1;
+
+struct ColumnFileHeader_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t num_bins;
+};
+
+struct ColumnGroupHeader_t
+{
+    uint32_t num_rows;
+    uint32_t num_maxima;
+    uint32_t num_targets;
+    uint32_t reserved;
+};
+
+struct BatchResult_t
+{
+    // Per frame
+    std::vector<int64_t> timestamp_ns;
+    std::vector<uint32_t> frame_number;
+    std::vector<float> max_magnitude;
+    std::vector<float> range_rx1;
+    std::vector<float> range_rx2;
+    std::vector<uint32_t> maxima_count;
+    std::vector<uint32_t> targets_count;
+
+    // Per maximum
+    std::vector<float> maxima_range;
+    std::vector<float> maxima_magnitude;
+
+    // Per target
+    std::vector<uint32_t> target_id;
+    std::vector<float> target_radius;
+    std::vector<float> target_azimuth;
+    std::vector<float> target_level;
+    std::vector<float> target_radial_speed;
+};
+
+class ColumnWriter
+{
+public:
+    ColumnWriter();
+    ~ColumnWriter();
+
+    bool open(QString const & path, DoubleVec_t const & range);
+    void write(BatchResult_t const & result);
+    void close();
+
+private:
+    template <typename T>
+    void writeColumn(std::vector<T> const & column);
+
+private:
+    QFile m_file;
+    bool m_failed;
+};
+
+#endif // COLUMNWRITER_H
@@ -0,0 +1,132 @@
+#include <misc/constants.h>
+#include <misc/messagehandler.h>
+#include <batch/batchprocessor.h>
+#include <batch/parametersweep.h>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+
+template <typename T, typename Parse>
+bool parseList(QString const & value, std::vector<T> & list, Parse parse)
+{
+    list.clear();
+
+    for (auto const & item : value.split(',', Qt::SkipEmptyParts))
+    {
+        T element;
+        if (!parse(item.trimmed(), element))
+        {
+            qCritical() << "Error: Invalid parameter value" << item;
+            return false;
+        }
+        list.push_back(element);
+    }
+
+    return !list.empty();
+}
+
+bool parseGrid(QCommandLineParser const & parser, SweepGrid_t & grid)
+{
+    auto toUInt = [](QString const & s, uint32_t & v) { bool ok; v = s.toUInt(&ok); return ok; };
+    auto toDouble = [](QString const & s, double & v) { bool ok; v = s.toDouble(&ok); return ok; };
+    auto toPadding = [](QString const & s, uint32_t & v) { bool ok; v = s.toUInt(&ok); return ok && SignalProcessor::isValidZeroPaddingFactor(v); };
+
+    return parseList(parser.value("window"), grid.windows, SignalProcessor::windowFromName)
+        && parseList(parser.value("padding"), grid.zero_padding_factors, toPadding)
+        && parseList(parser.value("persistence"), grid.persistence_thresholds, toDouble)
+        && parseList(parser.value("cfar-guard"), grid.cfar_guard_cells, toUInt)
+        && parseList(parser.value("cfar-training"), grid.cfar_training_cells, toUInt)
+        && parseList(parser.value("cfar-factor"), grid.cfar_threshold_factors, toDouble);
+}
+
+// Without --sweep, every parameter takes a single value
+bool parseSettings(QCommandLineParser const & parser, SignalProcessorSettings_t & settings)
+{
+    SweepGrid_t grid;
+    if (!parseGrid(parser, grid))
+        return false;
+
+    if (grid.windows.size() != 1 || grid.zero_padding_factors.size() != 1 || grid.persistence_thresholds.size() != 1 ||
+        grid.cfar_guard_cells.size() != 1 || grid.cfar_training_cells.size() != 1 || grid.cfar_threshold_factors.size() != 1)
+    {
+        qCritical() << "Error: Lists of parameter values require --sweep";
+        return false;
+    }
+
+    settings = {grid.windows.front(), grid.zero_padding_factors.front(), grid.persistence_thresholds.front(),
+                grid.cfar_guard_cells.front(), grid.cfar_training_cells.front(), grid.cfar_threshold_factors.front()};
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    qInstallMessageHandler(messageHandler);
+    QCoreApplication a(argc, argv);
+
+    SignalProcessorSettings_t defaults;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Offline batch processor for P2G-Dashboard recordings");
+    parser.addHelpOption();
+    parser.addPositionalArgument("recording", "Recording to process.");
+    parser.addOption({{"o", "output"}, "File to write, defaults to the recording path with a .cols or .sweep.csv suffix.", "file"});
+    parser.addOption({"threads", "Number of worker threads, defaults to the number of cores.", "count", "0"});
+    parser.addOption({"shard-size", "Number of frames processed per work item.", "frames", QString::number(BATCH_DEFAULT_SHARD_SIZE)});
+
+    // Signal processing parameters: with --sweep every option takes a comma separated list and all
+    // combinations are evaluated, otherwise the recording is processed with a single value each
+    parser.addOption({"sweep", "Evaluate detection statistics for a grid of signal processing parameters."});
+    parser.addOption({"window", "Window functions: rectangular, hann, hamming, blackman.", "list", SignalProcessor::windowName(defaults.window)});
+    parser.addOption({"padding", "Zero padding factors (powers of two).", "list", QString::number(defaults.zero_padding_factor)});
+    parser.addOption({"persistence", "Persistence thresholds of the range maxima.", "list", QString::number(defaults.persistence_threshold)});
+    parser.addOption({"cfar-guard", "CFAR guard cells per side.", "list", QString::number(defaults.cfar_guard_cells)});
+    parser.addOption({"cfar-training", "CFAR training cells per side, 0 disables CFAR.", "list", QString::number(defaults.cfar_training_cells)});
+    parser.addOption({"cfar-factor", "CFAR threshold factors.", "list", QString::number(defaults.cfar_threshold_factor)});
+    parser.addOption({"match-tolerance", "Range difference in meters up to which a maximum matches a sensor target.", "meters", QString::number(SWEEP_DEFAULT_MATCH_TOLERANCE)});
+    parser.process(a);
+
+    auto args = parser.positionalArguments();
+    if (args.size() != 1)
+        parser.showHelp(ERROR_BATCH_INVALID_ARGUMENTS);
+
+    auto input = args.first();
+    auto sweep = parser.isSet("sweep");
+    auto output = parser.isSet("output") ? parser.value("output") : input + (sweep ? ".sweep.csv" : ".cols");
+    auto success = false;
+
+    if (sweep)
+    {
+        SweepGrid_t grid;
+        if (!parseGrid(parser, grid))
+            return ERROR_BATCH_INVALID_ARGUMENTS;
+
+        ParameterSweep processor;
+        processor.setGrid(grid);
+        processor.setThreadCount(parser.value("threads").toInt());
+        processor.setShardSize(parser.value("shard-size").toUInt());
+        processor.setMatchTolerance(parser.value("match-tolerance").toDouble());
+        success = processor.run(input, output);
+    }
+    else
+    {
+        SignalProcessorSettings_t settings;
+        if (!parseSettings(parser, settings))
+            return ERROR_BATCH_INVALID_ARGUMENTS;
+
+        BatchProcessor processor;
+        processor.setSignalProcessorSettings(settings);
+        processor.setThreadCount(parser.value("threads").toInt());
+        processor.setShardSize(parser.value("shard-size").toUInt());
+        success = processor.run(input, output);
+    }
+
+    if (!success)
+    {
+        qCritical() << "Aborted: Failed to process recording.";
+        return ERROR_BATCH_PROCESSING_FAILED;
+    }
+
+    qInfo() << "Wrote" << output;
+    return 0;
+}
@@ -0,0 +1,255 @@
+#include "parametersweep.h"
+
+#include <misc/constants.h>
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <cmath>
+
+ParameterSweep::ParameterSweep()
+{
+    m_threads = QThread::idealThreadCount();
+    m_shard_size = BATCH_DEFAULT_SHARD_SIZE;
+    m_match_tolerance = SWEEP_DEFAULT_MATCH_TOLERANCE;
+}
+
+void ParameterSweep::setGrid(const SweepGrid_t &grid)
+{
+    m_grid = grid;
+    m_configurations.clear();
+    m_windows.clear();
+    m_ranges.clear();
+
+    // Same nesting as in processShard, so configurations can be addressed by a running index there
+    for (auto window : m_grid.windows)
+    {
+        m_windows.push_back(SignalProcessor::generateWindow(window));
+
+        for (auto padding : m_grid.zero_padding_factors)
+            for (auto threshold : m_grid.persistence_thresholds)
+                for (auto guard : m_grid.cfar_guard_cells)
+                    for (auto training : m_grid.cfar_training_cells)
+                        for (auto factor : m_grid.cfar_threshold_factors)
+                            m_configurations.push_back({window, padding, threshold, guard, training, factor});
+    }
+
+    for (auto padding : m_grid.zero_padding_factors)
+        m_ranges.push_back(SignalProcessor::generateRangeVector(padding));
+}
+
+void ParameterSweep::setThreadCount(int threads)
+{
+    m_threads = threads > 0 ? threads : QThread::idealThreadCount();
+}
+
+void ParameterSweep::setShardSize(size_t frames)
+{
+    m_shard_size = frames > 0 ? frames : BATCH_DEFAULT_SHARD_SIZE;
+}
+
+void ParameterSweep::setMatchTolerance(double meters)
+{
+    m_match_tolerance = meters;
+}
+
+bool ParameterSweep::run(const QString &input, const QString &output)
+{
+    if (m_configurations.empty())
+    {
+        qWarning() << "Parameter grid is empty.";
+        return false;
+    }
+
+    if (!m_reader.open(input))
+        return false;
+
+    auto frames = m_reader.frameCount();
+    auto shards = (frames + m_shard_size - 1) / m_shard_size;
+
+    qInfo() << "Evaluating" << m_configurations.size() << "configurations on" << frames << "frames with" << m_threads << "threads...";
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Every shard accumulates its own statistics and adds them to the totals when it is done, the sums
+    // don't depend on the order, so memory only grows with the number of threads
+    std::vector<SweepStatistics_t> statistics(m_configurations.size());
+    QMutex statistics_mutex;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(m_threads);
+
+    for (size_t shard = 0; shard < shards; shard++)
+    {
+        auto first = shard * m_shard_size;
+        auto last = std::min(first + m_shard_size, frames);
+
+        pool.start([this, first, last, &statistics, &statistics_mutex]()
+        {
+            std::vector<SweepStatistics_t> shard_statistics(statistics.size());
+            processShard(first, last, shard_statistics);
+
+            QMutexLocker locker(&statistics_mutex);
+            for (size_t i = 0; i < statistics.size(); i++)
+            {
+                statistics[i].frames += shard_statistics[i].frames;
+                statistics[i].detections += shard_statistics[i].detections;
+                statistics[i].frames_with_detections += shard_statistics[i].frames_with_detections;
+                statistics[i].targets += shard_statistics[i].targets;
+                statistics[i].matched_targets += shard_statistics[i].matched_targets;
+                statistics[i].unmatched_detections += shard_statistics[i].unmatched_detections;
+            }
+        });
+    }
+
+    pool.waitForDone();
+    m_reader.close();
+
+    qInfo() << "Evaluated" << m_configurations.size() << "configurations in" << timer.elapsed() << "ms";
+
+    return writeResults(output, statistics);
+}
+
+void ParameterSweep::processShard(size_t first, size_t last, std::vector<SweepStatistics_t> &statistics) const
+{
+    std::vector<float> samples;
+    Frame_Info_t frame_info;
+    RecordedFrameView_t view;
+
+    ComplexVec_t windowed;
+    DoubleVec_t spectrum;
+    std::vector<float> magnitudes;
+    p1d::Persistence1D persistence;
+    std::vector<p1d::TPairedExtrema> extrema;
+    std::vector<double> detections;
+    std::vector<double> targets;
+
+    for (auto i = first; i < last; i++)
+    {
+        if (!m_reader.frame(i, view))
+            continue;
+
+        m_reader.unpack(view, samples, frame_info);
+
+        size_t n = frame_info.num_samples_per_chirp;
+        if (n < SignalProcessor::sampleSize() || samples.size() < 4 * n)
+            continue;
+
+        targets.clear();
+        for (uint32_t t = 0; t < view.num_targets; t++)
+            targets.push_back(view.targets[t].radius / 100);
+
+        // Each stage is computed once and shared by all configurations that only differ in later stages
+        size_t configuration = 0;
+
+        for (size_t w = 0; w < m_grid.windows.size(); w++)
+        {
+            SignalProcessor::windowSignal(samples.data(), samples.data() + n, m_windows[w], windowed);
+
+            for (size_t p = 0; p < m_grid.zero_padding_factors.size(); p++)
+            {
+                SignalProcessor::calculateSpectrum(windowed, m_grid.zero_padding_factors[p], spectrum);
+
+                magnitudes.assign(spectrum.begin(), spectrum.end());
+                persistence.RunPersistence(magnitudes);
+
+                for (auto threshold : m_grid.persistence_thresholds)
+                {
+                    persistence.GetPairedExtrema(extrema, threshold);
+
+                    for (auto guard : m_grid.cfar_guard_cells)
+                    {
+                        for (auto training : m_grid.cfar_training_cells)
+                        {
+                            for (auto factor : m_grid.cfar_threshold_factors)
+                            {
+                                detections.clear();
+                                for (auto const & e : extrema)
+                                {
+                                    if (SignalProcessor::passesCfar(spectrum, e.MaxIndex, guard, training, factor))
+                                        detections.push_back(m_ranges[p][e.MaxIndex]);
+                                }
+
+                                accumulate(detections, targets, statistics[configuration++]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ParameterSweep::accumulate(const std::vector<double> &detections, const std::vector<double> &targets, SweepStatistics_t &statistics) const
+{
+    auto matches = [this](std::vector<double> const & candidates, double range)
+    {
+        return std::any_of(candidates.begin(), candidates.end(), [this, range](double c) { return std::abs(c - range) <= m_match_tolerance; });
+    };
+
+    statistics.frames++;
+    statistics.detections += detections.size();
+    statistics.targets += targets.size();
+
+    if (!detections.empty())
+        statistics.frames_with_detections++;
+
+    for (auto target : targets)
+    {
+        if (matches(detections, target))
+            statistics.matched_targets++;
+    }
+
+    for (auto detection : detections)
+    {
+        if (!matches(targets, detection))
+            statistics.unmatched_detections++;
+    }
+}
+
+bool ParameterSweep::writeResults(const QString &output, const std::vector<SweepStatistics_t> &statistics) const
+{
+    QFile file(output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        qWarning() << "Error while opening output file:" << output;
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "Window,ZeroPaddingFactor,PersistenceThreshold,CfarGuardCells,CfarTrainingCells,CfarThresholdFactor,"
+        << "Frames,Detections,DetectionsPerFrame,FramesWithDetections,Targets,MatchedTargets,TargetRecall,"
+        << "UnmatchedDetections,UnmatchedDetectionsPerFrame\n";
+
+    for (size_t i = 0; i < m_configurations.size(); i++)
+    {
+        auto const & c = m_configurations[i];
+        auto const & s = statistics[i];
+        auto frames = std::max<quint64>(s.frames, 1);
+
+        out << SignalProcessor::windowName(c.window) << ","
+            << c.zero_padding_factor << ","
+            << c.persistence_threshold << ","
+            << c.cfar_guard_cells << ","
+            << c.cfar_training_cells << ","
+            << c.cfar_threshold_factor << ","
+            << s.frames << ","
+            << s.detections << ","
+            << static_cast<double>(s.detections) / frames << ","
+            << s.frames_with_detections << ","
+            << s.targets << ","
+            << s.matched_targets << ","
+            << (s.targets > 0 ? static_cast<double>(s.matched_targets) / s.targets : 0.0) << ","
+            << s.unmatched_detections << ","
+            << static_cast<double>(s.unmatched_detections) / frames << "\n";
+    }
+
+    file.close();
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+#include <logic/recording/recordingreader.h>
+#include <logic/signalprocessor/signalprocessor.h>
+
+#include <QString>
+#include <vector>
+
+struct SweepGrid_t
+{
+    std::vector<WindowType_t> windows;
+    std::vector<uint32_t> zero_padding_factors;
+    std::vector<double> persistence_thresholds;
+    std::vector<uint32_t> cfar_guard_cells;
+    std::vector<uint32_t> cfar_training_cells;
+    std::vector<double> cfar_threshold_factors;
+};
+
+// Detections are the range maxima of antenna 1, compared against the targets reported by the sensor
+struct SweepStatistics_t
+{
+    quint64 frames = 0;
+    quint64 detections = 0;
+    quint64 frames_with_detections = 0;
+    quint64 targets = 0;
+    quint64 matched_targets = 0;
+    quint64 unmatched_detections = 0;
+};
+
+class ParameterSweep
+{
+public:
+    ParameterSweep();
+
+    void setGrid(SweepGrid_t const & grid);
+    void setThreadCount(int threads);
+    void setShardSize(size_t frames);
+    void setMatchTolerance(double meters);
+    bool run(QString const & input, QString const & output);
+
+private:
+    void processShard(size_t first, size_t last, std::vector<SweepStatistics_t> & statistics) const;
+    void accumulate(std::vector<double> const & detections, std::vector<double> const & targets, SweepStatistics_t & statistics) const;
+    bool writeResults(QString const & output, std::vector<SweepStatistics_t> const & statistics) const;
+
+private:
+    RecordingReader m_reader;
+    SweepGrid_t m_grid;
+    std::vector<SignalProcessorSettings_t> m_configurations;
+    std::vector<DoubleVec_t> m_windows;
+    std::vector<DoubleVec_t> m_ranges;
+    int m_threads;
+    size_t m_shard_size;
+    double m_match_tolerance;
+};
+
+#endif // PARAMETERSWEEP_H
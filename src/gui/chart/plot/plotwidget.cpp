@@ -0,0 +1,494 @@
+#include "plotwidget.h"
+
+#include <logic/metrics/latencymetrics.h>
+#include <logic/metrics/tracerecorder.h>
+
+#include <QFontMetrics>
+#include <QLinearGradient>
+#include <QMutexLocker>
+#include <utility>
+
+// Constants
+constexpr auto PLOT_MARGIN = 8;
+constexpr auto PLOT_SPACING = 6;
+constexpr auto PLOT_TITLE_FONT_SIZE = 20;
+constexpr auto PLOT_TICK_COUNT = 5;
+constexpr auto PLOT_LINE_WIDTH = 2;
+constexpr auto PLOT_LEGEND_MARKER_SIZE = 12;
+constexpr auto PLOT_MARKER_RADIUS = 6;
+constexpr auto PLOT_FILL_ALPHA = 96;
+
+const QColor PLOT_BACKGROUND_TOP(0x05, 0x61, 0x89);
+const QColor PLOT_BACKGROUND_BOTTOM(0x10, 0x1a, 0x31);
+const QColor PLOT_GRID_COLOR(0xff, 0xff, 0xff, 0x30);
+const QColor PLOT_AXIS_COLOR(0xd6, 0xd6, 0xd6);
+const QColor PLOT_TEXT_COLOR(Qt::white);
+
+PlotWidget::PlotWidget(QWidget *parent) : QWidget(parent)
+{
+    m_scene.ratio = 1.0;
+    m_scene.background_version = 0;
+    m_scene.title_font.setPixelSize(PLOT_TITLE_FONT_SIZE);
+    m_scene.x_precision = 1;
+    m_scene.y_precision = 1;
+    m_scene.x_min = 0.0;
+    m_scene.x_max = 1.0;
+    m_scene.y_min = 0.0;
+    m_scene.y_max = 1.0;
+    m_scene.marker_count = 0;
+    m_scene.timestamp_ns = 0;
+    m_render_scheduled = false;
+    m_background_version = 0;
+    m_front_timestamp = 0;
+
+    // Every pixel is painted in paintEvent, Qt does not need to clear the background before
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+    m_render_pending = false;
+    m_rendering = true;
+    m_render_thread = QThread::create([this]() { renderLoop(); });
+    m_render_thread->setObjectName("PlotRenderer");
+    m_render_thread->start();
+}
+
+PlotWidget::~PlotWidget()
+{
+    stopRendering();
+}
+
+void PlotWidget::setTitle(const QString &title)
+{
+    m_scene.title = title;
+    invalidateBackground();
+}
+
+void PlotWidget::setAxisTitles(const QString &x, const QString &y)
+{
+    m_scene.x_title = x;
+    m_scene.y_title = y;
+    invalidateBackground();
+}
+
+void PlotWidget::setAxisPrecision(int x, int y)
+{
+    m_scene.x_precision = x;
+    m_scene.y_precision = y;
+    invalidateBackground();
+}
+
+void PlotWidget::setXRange(double min, double max)
+{
+    if (min == m_scene.x_min && max == m_scene.x_max)
+        return;
+
+    m_scene.x_min = min;
+    m_scene.x_max = max;
+    invalidateBackground();
+}
+
+void PlotWidget::setYRange(double min, double max)
+{
+    if (min == m_scene.y_min && max == m_scene.y_max)
+        return;
+
+    m_scene.y_min = min;
+    m_scene.y_max = max;
+    invalidateBackground();
+}
+
+int PlotWidget::addCurve(const QString &name, const QColor &color, bool filled)
+{
+    m_scene.curves.push_back({name, color, filled, {}, 0});
+    invalidateBackground();
+    return static_cast<int>(m_scene.curves.size()) - 1;
+}
+
+void PlotWidget::setCurve(int curve, const float *y, int size, double x0, double dx)
+{
+    auto c = reserveCurve(curve, size);
+    if (c == nullptr)
+        return;
+
+    auto points = c->points.data();
+    for (auto i = 0; i < size; i++)
+        points[i] = QPointF(x0 + i * dx, y[i]);
+
+    closeCurve(*c);
+    scheduleRender();
+}
+
+void PlotWidget::setCurve(int curve, const DataPoints_t &points)
+{
+    auto c = reserveCurve(curve, points.size());
+    if (c == nullptr)
+        return;
+
+    auto p = c->points.data();
+    for (auto const & point : points)
+        *p++ = point;
+
+    closeCurve(*c);
+    scheduleRender();
+}
+
+void PlotWidget::setMarkerStyle(const QString &name, const QColor &color, const QString &unit)
+{
+    m_scene.marker_name = name;
+    m_scene.marker_color = color;
+    m_scene.marker_unit = unit;
+    invalidateBackground();
+}
+
+void PlotWidget::setMarkers(const DataPoints_t &markers)
+{
+    if (m_scene.markers.size() < static_cast<size_t>(markers.size()))
+        m_scene.markers.resize(markers.size());
+
+    auto p = m_scene.markers.data();
+    for (auto const & marker : markers)
+        *p++ = marker;
+
+    m_scene.marker_count = markers.size();
+    scheduleRender();
+}
+
+void PlotWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+
+    QPainter painter(this);
+    qint64 timestamp_ns;
+    {
+        QMutexLocker locker(&m_front_mutex);
+        if (m_front.isNull())
+        {
+            painter.fillRect(rect(), PLOT_BACKGROUND_BOTTOM);
+            return;
+        }
+
+        // While resizing, the last image is stretched until the next one is rendered
+        painter.drawImage(rect(), m_front);
+        timestamp_ns = m_front_timestamp;
+        m_front_timestamp = 0;
+    }
+
+    if (timestamp_ns != 0)
+        framePainted(timestamp_ns);
+}
+
+void PlotWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    scheduleRender();
+}
+
+void PlotWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    scheduleRender();
+}
+
+void PlotWidget::scheduleRender()
+{
+    if (m_render_scheduled)
+        return;
+
+    // All changes until the event loop continues end up in one scene
+    m_render_scheduled = true;
+    QMetaObject::invokeMethod(this, [this]() {
+        m_render_scheduled = false;
+        submitScene();
+    }, Qt::QueuedConnection);
+}
+
+void PlotWidget::setTimestamp(qint64 timestamp_ns)
+{
+    m_scene.timestamp_ns = timestamp_ns;
+}
+
+void PlotWidget::stopRendering()
+{
+    if (m_render_thread == nullptr)
+        return;
+
+    m_rendering = false;
+    m_render_requests.release();
+    m_render_thread->wait();
+    delete m_render_thread;
+    m_render_thread = nullptr;
+}
+
+void PlotWidget::renderPlotArea(QPainter &painter, const QRectF &area)
+{
+    Q_UNUSED(painter)
+    Q_UNUSED(area)
+}
+
+void PlotWidget::framePainted(qint64 timestamp_ns)
+{
+    Q_UNUSED(timestamp_ns)
+}
+
+PlotCurve_t *PlotWidget::reserveCurve(int curve, int size)
+{
+    if (curve < 0 || curve >= static_cast<int>(m_scene.curves.size()))
+        return nullptr;
+
+    auto & c = m_scene.curves[curve];
+    if (c.points.size() < static_cast<size_t>(size + 2))
+        c.points.resize(size + 2);
+
+    c.size = size;
+    return &c;
+}
+
+void PlotWidget::closeCurve(PlotCurve_t &curve)
+{
+    if (!curve.filled || curve.size == 0)
+        return;
+
+    auto points = curve.points.data();
+    points[curve.size] = QPointF(points[curve.size - 1].x(), 0.0);
+    points[curve.size + 1] = QPointF(points[0].x(), 0.0);
+}
+
+void PlotWidget::invalidateBackground()
+{
+    m_scene.background_version++;
+    scheduleRender();
+}
+
+void PlotWidget::submitScene()
+{
+    // Hidden widgets don't render, which also keeps the render thread away from subclasses under construction
+    if (!isVisible() || size().isEmpty() || m_render_thread == nullptr)
+        return;
+
+    m_scene.size = size();
+    m_scene.ratio = devicePixelRatioF();
+    m_scene.font = font();
+    m_scenes.put(m_scene);
+    m_scene.timestamp_ns = 0;
+
+    if (!m_render_pending.exchange(true))
+        m_render_requests.release();
+}
+
+void PlotWidget::renderLoop()
+{
+    TraceRecorder::instance().setThreadName("PlotRenderer");
+
+    for (;;)
+    {
+        m_render_requests.acquire();
+        if (!m_rendering)
+            break;
+
+        // Cleared before taking the scene, so a scene put meanwhile requests another render
+        m_render_pending = false;
+        if (auto scene = m_scenes.take())
+            render(*scene);
+    }
+}
+
+void PlotWidget::render(const PlotScene_t &scene)
+{
+    LatencyScope scope(LatencyStage_t::ChartUpdate);
+    TraceScope trace("PlotWidget::render");
+
+    auto pixels = scene.size * scene.ratio;
+    if (m_background.size() != pixels || m_background_version != scene.background_version)
+        renderBackground(scene);
+
+    if (m_back.size() != pixels)
+    {
+        m_back = QImage(pixels, QImage::Format_ARGB32_Premultiplied);
+        m_back.setDevicePixelRatio(scene.ratio);
+    }
+
+    QPainter painter(&m_back);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(0, 0, m_background);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    if (!m_plot_area.isEmpty())
+    {
+        painter.setClipRect(m_plot_area);
+        renderPlotArea(painter, m_plot_area);
+
+        // Curves are drawn in data coordinates; cosmetic pens keep their width under the transform
+        painter.setTransform(m_transform);
+        for (auto const & c : scene.curves)
+        {
+            if (c.size < 2)
+                continue;
+
+            QPen pen(c.color, PLOT_LINE_WIDTH);
+            pen.setCosmetic(true);
+            painter.setPen(pen);
+
+            if (c.filled)
+            {
+                auto fill = c.color;
+                fill.setAlpha(PLOT_FILL_ALPHA);
+                painter.setBrush(fill);
+                painter.drawPolygon(c.points.data(), c.size + 2);
+            }
+            else
+            {
+                painter.drawPolyline(c.points.data(), c.size);
+            }
+        }
+
+        painter.resetTransform();
+        painter.setFont(scene.font);
+        painter.setPen(QPen(PLOT_TEXT_COLOR, 1));
+        painter.setBrush(scene.marker_color);
+        for (auto i = 0; i < scene.marker_count; i++)
+        {
+            auto p = m_transform.map(scene.markers[i]);
+            painter.drawEllipse(p, PLOT_MARKER_RADIUS, PLOT_MARKER_RADIUS);
+            painter.drawText(p + QPointF(PLOT_MARKER_RADIUS + 2, -PLOT_MARKER_RADIUS - 2),
+                             QString::number(scene.markers[i].x(), 'f', 2) + scene.marker_unit);
+        }
+    }
+    painter.end();
+
+    {
+        QMutexLocker locker(&m_front_mutex);
+        std::swap(m_front, m_back);
+        if (scene.timestamp_ns != 0)
+            m_front_timestamp = scene.timestamp_ns;
+    }
+
+    QMetaObject::invokeMethod(this, [this]() { update(); }, Qt::QueuedConnection);
+}
+
+void PlotWidget::renderBackground(const PlotScene_t &scene)
+{
+    TraceScope trace("PlotWidget::renderBackground");
+
+    auto width = scene.size.width();
+    auto height = scene.size.height();
+    m_background = QImage(scene.size * scene.ratio, QImage::Format_ARGB32_Premultiplied);
+    m_background.setDevicePixelRatio(scene.ratio);
+    m_background_version = scene.background_version;
+
+    QPainter painter(&m_background);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    QLinearGradient gradient(0, 0, 0, height);
+    gradient.setColorAt(0.0, PLOT_BACKGROUND_TOP);
+    gradient.setColorAt(1.0, PLOT_BACKGROUND_BOTTOM);
+    painter.fillRect(QRect(0, 0, width, height), gradient);
+
+    // Title and legend
+    painter.setPen(PLOT_TEXT_COLOR);
+    painter.setFont(scene.title_font);
+    auto title_height = QFontMetrics(scene.title_font).height();
+    painter.drawText(QRect(0, PLOT_MARGIN, width, title_height), Qt::AlignCenter, scene.title);
+
+    painter.setFont(scene.font);
+    auto top = renderLegend(painter, scene, PLOT_MARGIN + title_height + PLOT_SPACING) + PLOT_SPACING;
+
+    // Plot area, leaving room for the axis titles and labels
+    QFontMetrics metrics(scene.font);
+    auto label_width = 0;
+    for (auto i = 0; i < PLOT_TICK_COUNT; i++)
+    {
+        auto value = scene.y_min + i * (scene.y_max - scene.y_min) / (PLOT_TICK_COUNT - 1);
+        label_width = qMax(label_width, metrics.horizontalAdvance(QString::number(value, 'f', scene.y_precision)));
+    }
+
+    auto left = PLOT_MARGIN + metrics.height() + PLOT_SPACING + label_width + PLOT_SPACING;
+    auto right = width - PLOT_MARGIN - metrics.horizontalAdvance(QString::number(scene.x_max, 'f', scene.x_precision)) / 2;
+    auto bottom = height - PLOT_MARGIN - 2 * metrics.height() - 2 * PLOT_SPACING;
+    m_plot_area = QRectF(left, top, right - left, bottom - top);
+
+    if (m_plot_area.width() <= 0 || m_plot_area.height() <= 0 || scene.x_max <= scene.x_min || scene.y_max <= scene.y_min)
+    {
+        m_plot_area = QRectF();
+        return;
+    }
+
+    auto sx = m_plot_area.width() / (scene.x_max - scene.x_min);
+    auto sy = -m_plot_area.height() / (scene.y_max - scene.y_min);
+    m_transform = QTransform(sx, 0.0, 0.0, sy, m_plot_area.left() - scene.x_min * sx, m_plot_area.bottom() - scene.y_min * sy);
+
+    // Grid and tick labels
+    for (auto i = 0; i < PLOT_TICK_COUNT; i++)
+    {
+        auto x = scene.x_min + i * (scene.x_max - scene.x_min) / (PLOT_TICK_COUNT - 1);
+        auto px = m_transform.map(QPointF(x, scene.y_min)).x();
+        painter.setPen(PLOT_GRID_COLOR);
+        painter.drawLine(QPointF(px, m_plot_area.top()), QPointF(px, m_plot_area.bottom()));
+        painter.setPen(PLOT_TEXT_COLOR);
+        painter.drawText(QRectF(px - 50, m_plot_area.bottom() + PLOT_SPACING, 100, metrics.height()),
+                         Qt::AlignHCenter | Qt::AlignTop, QString::number(x, 'f', scene.x_precision));
+
+        auto y = scene.y_min + i * (scene.y_max - scene.y_min) / (PLOT_TICK_COUNT - 1);
+        auto py = m_transform.map(QPointF(scene.x_min, y)).y();
+        painter.setPen(PLOT_GRID_COLOR);
+        painter.drawLine(QPointF(m_plot_area.left(), py), QPointF(m_plot_area.right(), py));
+        painter.setPen(PLOT_TEXT_COLOR);
+        painter.drawText(QRectF(m_plot_area.left() - PLOT_SPACING - label_width, py - metrics.height() / 2.0, label_width, metrics.height()),
+                         Qt::AlignRight | Qt::AlignVCenter, QString::number(y, 'f', scene.y_precision));
+    }
+
+    painter.setPen(PLOT_AXIS_COLOR);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(m_plot_area);
+
+    // Axis titles
+    painter.setPen(PLOT_TEXT_COLOR);
+    painter.drawText(QRectF(m_plot_area.left(), height - PLOT_MARGIN - metrics.height(), m_plot_area.width(), metrics.height()),
+                     Qt::AlignCenter, scene.x_title);
+
+    painter.save();
+    painter.translate(PLOT_MARGIN, m_plot_area.bottom());
+    painter.rotate(-90);
+    painter.drawText(QRectF(0, 0, m_plot_area.height(), metrics.height()), Qt::AlignCenter, scene.y_title);
+    painter.restore();
+}
+
+int PlotWidget::renderLegend(QPainter &painter, const PlotScene_t &scene, int y)
+{
+    QFontMetrics metrics(painter.font());
+    auto entry_width = [&](QString const & name)
+    {
+        return PLOT_LEGEND_MARKER_SIZE + PLOT_SPACING + metrics.horizontalAdvance(name) + 3 * PLOT_SPACING;
+    };
+
+    auto total = 0;
+    for (auto const & c : scene.curves)
+        total += entry_width(c.name);
+    if (!scene.marker_name.isEmpty())
+        total += entry_width(scene.marker_name);
+
+    if (total == 0)
+        return y;
+
+    auto x = (scene.size.width() - total) / 2;
+    auto marker_y = y + (metrics.height() - PLOT_LEGEND_MARKER_SIZE) / 2;
+    auto draw_entry = [&](QString const & name, QColor const & color, bool round)
+    {
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(color);
+        if (round)
+            painter.drawEllipse(QRect(x, marker_y, PLOT_LEGEND_MARKER_SIZE, PLOT_LEGEND_MARKER_SIZE));
+        else
+            painter.drawRect(QRect(x, marker_y, PLOT_LEGEND_MARKER_SIZE, PLOT_LEGEND_MARKER_SIZE));
+
+        painter.setPen(PLOT_TEXT_COLOR);
+        painter.drawText(x + PLOT_LEGEND_MARKER_SIZE + PLOT_SPACING, y + metrics.ascent(), name);
+        x += entry_width(name);
+    };
+
+    for (auto const & c : scene.curves)
+        draw_entry(c.name, c.color, false);
+    if (!scene.marker_name.isEmpty())
+        draw_entry(scene.marker_name, scene.marker_color, true);
+
+    return y + metrics.height();
+}
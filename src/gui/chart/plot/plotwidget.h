@@ -0,0 +1,136 @@
+#ifndef PLOTWIDGET_H
+#define PLOTWIDGET_H
+
+#include <misc/mailbox.h>
+#include <misc/types.h>
+
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QMutex>
+#include <QPainter>
+#include <QRectF>
+#include <QSemaphore>
+#include <QThread>
+#include <QTransform>
+#include <QWidget>
+#include <atomic>
+#include <vector>
+
+struct PlotCurve_t
+{
+    QString name;
+    QColor color;
+    bool filled;                    // Area between the curve and y = 0
+    std::vector<QPointF> points;    // Preallocated, only grows; filled curves use two extra points for the baseline
+    int size;
+};
+
+// Everything needed to draw the plot, copied from the gui thread to the render thread
+struct PlotScene_t
+{
+    QSize size;
+    qreal ratio;
+    quint64 background_version;     // Changes whenever title, legend or axes change
+    QFont font;
+    QFont title_font;
+    QString title;
+    QString x_title;
+    QString y_title;
+    int x_precision;
+    int y_precision;
+    double x_min;
+    double x_max;
+    double y_min;
+    double y_max;
+    std::vector<PlotCurve_t> curves;
+    QString marker_name;
+    QColor marker_color;
+    QString marker_unit;
+    std::vector<QPointF> markers;   // Preallocated, only grows
+    int marker_count;
+    qint64 timestamp_ns;            // Acquisition time of the shown data, 0 if it didn't change
+};
+
+// Plot for data that changes every frame, rasterized on a render thread of its own. The gui thread only
+// collects the changes of one event loop iteration into a scene and blits the last finished image, so
+// neither heavy plotting nor resizing stalls the event loop. Curves are drawn as polylines from
+// preallocated buffers, title, legend, axes and grid are cached in an image which is only regenerated
+// when the widget is resized or an axis changes.
+class PlotWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PlotWidget(QWidget *parent = nullptr);
+    ~PlotWidget();
+
+    void setTitle(QString const & title);
+    void setAxisTitles(QString const & x, QString const & y);
+    void setAxisPrecision(int x, int y);
+    void setXRange(double min, double max);
+    void setYRange(double min, double max);
+
+    int addCurve(QString const & name, QColor const & color, bool filled = false);
+    void setCurve(int curve, float const * y, int size, double x0 = 0.0, double dx = 1.0);
+    void setCurve(int curve, DataPoints_t const & points);
+
+    void setMarkerStyle(QString const & name, QColor const & color, QString const & unit);
+    void setMarkers(DataPoints_t const & markers);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+
+    // Renders the scene with the next iteration of the event loop
+    void scheduleRender();
+    void setTimestamp(qint64 timestamp_ns);
+
+    // Subclasses which override renderPlotArea() have to stop rendering in their destructor
+    void stopRendering();
+
+    // Called on the render thread: draws into the plot area below the curves, in widget coordinates
+    virtual void renderPlotArea(QPainter & painter, QRectF const & area);
+
+    // Called on the gui thread when an image with data of the given acquisition time is shown first
+    virtual void framePainted(qint64 timestamp_ns);
+
+private:
+    PlotCurve_t * reserveCurve(int curve, int size);
+    void closeCurve(PlotCurve_t & curve);
+    void invalidateBackground();
+    void submitScene();
+
+    // Render thread
+    void renderLoop();
+    void render(PlotScene_t const & scene);
+    void renderBackground(PlotScene_t const & scene);
+    int renderLegend(QPainter & painter, PlotScene_t const & scene, int y);
+
+private:
+    // Gui thread
+    PlotScene_t m_scene;
+    bool m_render_scheduled;
+
+    // Gui thread --> Render thread
+    Mailbox<PlotScene_t> m_scenes;
+    QSemaphore m_render_requests;
+    std::atomic<bool> m_render_pending;
+    std::atomic<bool> m_rendering;
+    QThread *m_render_thread;
+
+    // Render thread
+    QImage m_background;
+    quint64 m_background_version;
+    QImage m_back;
+    QRectF m_plot_area;
+    QTransform m_transform;
+
+    // Render thread --> Gui thread
+    QMutex m_front_mutex;
+    QImage m_front;
+    qint64 m_front_timestamp;
+};
+
+#endif // PLOTWIDGET_H
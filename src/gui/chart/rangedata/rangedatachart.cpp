@@ -1,70 +1,49 @@
 #include "rangedatachart.h"
 
-RangeDataChart::RangeDataChart()
-{
-    m_range_data_series_rx1.setUpperSeries(&m_range_data_series_upper_rx1);
-    m_range_data_series_rx2.setUpperSeries(&m_range_data_series_upper_rx2);
+#include <logic/metrics/latencymetrics.h>
+#include <logic/metrics/telemetry.h>
+#include <logic/metrics/tracerecorder.h>
+
+#include <cmath>
 
+// Constants
+constexpr auto RANGE_DATA_Y_HEADROOM = 0.2;
+constexpr auto RANGE_DATA_Y_STEP = 0.5;     // Rounding the axis maximum keeps the cached axes valid between frames
+
+RangeDataChart::RangeDataChart(QWidget *parent) : PlotWidget(parent)
+{
     initialize();
 }
 
-void RangeDataChart::update(const DataPoints_t &rx1, const DataPoints_t &rx2, const DataPoints_t &maxima, const double &max_y)
+void RangeDataChart::setData(const DataPoints_t &rx1, const DataPoints_t &rx2, const DataPoints_t &maxima, const double &max_y, qint64 timestamp_ns)
 {
-    m_range_data_series_upper_rx1.clear();
-    m_range_data_series_upper_rx2.clear();
-    m_range_data_maximum_rx1.clear();
+    TraceScope trace("RangeDataChart::setData");
 
-    m_range_data_series_upper_rx1.append(rx1);
-    m_range_data_series_upper_rx2.append(rx2);
-    m_range_data_maximum_rx1.append(maxima);
-
-    static_cast<QValueAxis*>(axes(Qt::Vertical).back())->setMax(max_y + 0.2);
+    setCurve(m_range_data_series_rx1, rx1);
+    setCurve(m_range_data_series_rx2, rx2);
+    setMarkers(maxima);
+    setYRange(0, std::ceil((max_y + RANGE_DATA_Y_HEADROOM) / RANGE_DATA_Y_STEP) * RANGE_DATA_Y_STEP);
+    setTimestamp(timestamp_ns);
 }
 
-void RangeDataChart::initialize()
+void RangeDataChart::framePainted(qint64 timestamp_ns)
 {
-    m_range_data_series_rx1.setName("Antenna 1");
-    m_range_data_series_rx2.setName("Antenna 2");
-
-    m_range_data_maximum_rx1.setName("All extrema");
-    m_range_data_maximum_rx1.setMarkerShape(QScatterSeries::MarkerShapeCircle);
-    m_range_data_maximum_rx1.setMarkerSize(12);
-    m_range_data_maximum_rx1.setBrush(Qt::red);
-    m_range_data_maximum_rx1.setBorderColor(Qt::white);
-    m_range_data_maximum_rx1.setPointLabelsVisible(true);
-    m_range_data_maximum_rx1.setPointLabelsColor(Qt::white);
-    m_range_data_maximum_rx1.setPointLabelsFormat("@xPoint m");
+    Telemetry::instance().guiFrameRendered();
 
-    setTheme(QChart::ChartThemeBlueCerulean);
-    addSeries(&m_range_data_series_rx1);
-    addSeries(&m_range_data_series_rx2);
-    addSeries(&m_range_data_maximum_rx1);
-    setTitle("Range spectrum");
-
-    auto axisX = new QValueAxis;
-    axisX->setTitleText("Range [m]");
-    axisX->setRange(0, 10);
-    axisX->setLabelFormat("%.1f");
-    addAxis(axisX, Qt::AlignBottom);
-    m_range_data_series_rx1.attachAxis(axisX);
-    m_range_data_series_rx2.attachAxis(axisX);
-    m_range_data_maximum_rx1.attachAxis(axisX);
-
-    auto axisY = new QValueAxis;
-    axisY->setTitleText("Magnitude");
-    axisY->setRange(0, 1.0);
-    axisY->setLabelFormat("%.1f");
-    addAxis(axisY, Qt::AlignLeft);
-    m_range_data_series_rx1.attachAxis(axisY);
-    m_range_data_series_rx2.attachAxis(axisY);
-    m_range_data_maximum_rx1.attachAxis(axisY);
-
-    setFontSize(20);
+    auto & metrics = LatencyMetrics::instance();
+    if (metrics.isEndToEndEnabled())
+        metrics.record(LatencyStage_t::EndToEnd, monotonicTimestamp() - timestamp_ns);
 }
 
-void RangeDataChart::setFontSize(size_t size)
+void RangeDataChart::initialize()
 {
-    QFont font;
-    font.setPixelSize(size);
-    setTitleFont(font);
+    m_range_data_series_rx1 = addCurve("Antenna 1", QColor(0xc7, 0xe8, 0x5b), true);
+    m_range_data_series_rx2 = addCurve("Antenna 2", QColor(0x1c, 0xb5, 0x4f), true);
+    setMarkerStyle("All extrema", Qt::red, " m");
+
+    setTitle("Range spectrum");
+    setAxisTitles("Range [m]", "Magnitude");
+    setAxisPrecision(1, 1);
+    setXRange(0, 10);
+    setYRange(0, 1.0);
 }
@@ -1,32 +1,29 @@
 #ifndef RANGEDATACHART_H
 #define RANGEDATACHART_H
 
+#include <gui/chart/plot/plotwidget.h>
 #include <misc/types.h>
 
-#include <QtCharts>
-
-using namespace QtCharts;
-
-class RangeDataChart : public QChart
+class RangeDataChart : public PlotWidget
 {
     Q_OBJECT
 
 public:
-    RangeDataChart();
+    explicit RangeDataChart(QWidget *parent = nullptr);
 
 public slots:
-    void update(DataPoints_t const & rx1, DataPoints_t const & rx2,
-                DataPoints_t const & maxima, double const & max_y);
+    void setData(DataPoints_t const & rx1, DataPoints_t const & rx2,
+                 DataPoints_t const & maxima, double const & max_y, qint64 timestamp_ns);
+
+protected:
+    void framePainted(qint64 timestamp_ns) override;
+
 private:
     void initialize();
-    void setFontSize(size_t size);
 
 private:
-    QAreaSeries m_range_data_series_rx1;
-    QLineSeries m_range_data_series_upper_rx1;
-    QAreaSeries m_range_data_series_rx2;
-    QLineSeries m_range_data_series_upper_rx2;
-    QScatterSeries m_range_data_maximum_rx1;
+    int m_range_data_series_rx1;
+    int m_range_data_series_rx2;
 };
 
 #endif // RANGEDATACHART_H
@@ -0,0 +1,112 @@
+#include "occupancyheatmap.h"
+
+#include <misc/clock.h>
+
+#include <QPainter>
+#include <cmath>
+
+// Constants
+constexpr auto HEATMAP_Z_VALUE = 9;             // Above the series, below the target trails
+constexpr auto HEATMAP_MAX_RADIUS = 10.0;
+constexpr auto HEATMAP_SATURATION = 5.0;        // Decayed detections drawn at half intensity
+constexpr auto HEATMAP_MIN_INTENSITY = 0.02;
+constexpr auto HEATMAP_MAX_ALPHA = 200;
+
+OccupancyHeatmap::OccupancyHeatmap(QChart *chart, QAbstractSeries *series) : QGraphicsItem(chart), m_cells()
+{
+    m_chart = chart;
+    m_series = series;
+    m_settings = {true, 60.0};
+
+    setZValue(HEATMAP_Z_VALUE);
+    QObject::connect(chart, &QChart::plotAreaChanged, chart, [this](QRectF const &) { prepareGeometryChange(); });
+}
+
+void OccupancyHeatmap::setSettings(const HeatmapSettings_t &settings)
+{
+    m_settings = settings;
+    setVisible(m_settings.enabled);
+}
+
+void OccupancyHeatmap::addTargets(const Targets_t &targets)
+{
+    if (!m_settings.enabled || targets.isEmpty())
+        return;
+
+    auto now = monotonicTimestamp();
+    for (auto const & target : targets)
+    {
+        auto radius = static_cast<int>(target.radius / 100 / HEATMAP_MAX_RADIUS * HEATMAP_RADIUS_BINS);
+        auto azimuth = static_cast<int>((target.azimuth + 180.0) / 360.0 * HEATMAP_AZIMUTH_BINS);
+        if (radius < 0 || radius >= HEATMAP_RADIUS_BINS || azimuth < 0 || azimuth >= HEATMAP_AZIMUTH_BINS)
+            continue;
+
+        auto & cell = m_cells[radius * HEATMAP_AZIMUTH_BINS + azimuth];
+        cell.value = decayed(cell, now) + 1.0f;
+        cell.updated_ns = now;
+    }
+
+    update();
+}
+
+void OccupancyHeatmap::clear()
+{
+    m_cells.fill({0.0f, 0});
+    update();
+}
+
+QRectF OccupancyHeatmap::boundingRect() const
+{
+    return m_chart->plotArea();
+}
+
+void OccupancyHeatmap::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option)
+    Q_UNUSED(widget)
+
+    painter->setPen(Qt::NoPen);
+    painter->setClipRect(m_chart->plotArea());
+
+    auto now = monotonicTimestamp();
+    auto radius_step = HEATMAP_MAX_RADIUS / HEATMAP_RADIUS_BINS;
+    auto azimuth_step = 360.0 / HEATMAP_AZIMUTH_BINS;
+    for (auto r = 0; r < HEATMAP_RADIUS_BINS; r++)
+    {
+        for (auto a = 0; a < HEATMAP_AZIMUTH_BINS; a++)
+        {
+            auto const & cell = m_cells[r * HEATMAP_AZIMUTH_BINS + a];
+            if (cell.value == 0.0f)
+                continue;
+
+            auto value = decayed(cell, now);
+            auto intensity = value / (value + HEATMAP_SATURATION);
+            if (intensity < HEATMAP_MIN_INTENSITY)
+                continue;
+
+            // Cells are small enough to be drawn as quadrilaterals instead of ring segments
+            auto azimuth = -180.0 + a * azimuth_step;
+            auto radius = r * radius_step;
+            QPointF corners[] = {
+                m_chart->mapToPosition(QPointF(azimuth, radius), m_series),
+                m_chart->mapToPosition(QPointF(azimuth + azimuth_step, radius), m_series),
+                m_chart->mapToPosition(QPointF(azimuth + azimuth_step, radius + radius_step), m_series),
+                m_chart->mapToPosition(QPointF(azimuth, radius + radius_step), m_series)
+            };
+
+            // From yellow for few to red for many detections
+            auto color = QColor::fromHsvF((1.0 - intensity) / 6.0, 1.0, 1.0);
+            color.setAlpha(qRound(intensity * HEATMAP_MAX_ALPHA));
+            painter->setBrush(color);
+            painter->drawPolygon(corners, 4);
+        }
+    }
+}
+
+float OccupancyHeatmap::decayed(const HeatmapCell_t &cell, qint64 now) const
+{
+    if (cell.value == 0.0f)
+        return 0.0f;
+
+    return cell.value * std::exp2(-(now - cell.updated_ns) / 1e9 / m_settings.half_life);
+}
@@ -0,0 +1,53 @@
+#ifndef OCCUPANCYHEATMAP_H
+#define OCCUPANCYHEATMAP_H
+
+#include <misc/types.h>
+
+#include <QGraphicsItem>
+#include <QtCharts>
+#include <array>
+
+using namespace QtCharts;
+
+// Constants
+constexpr auto HEATMAP_RADIUS_BINS = 50;    // 0.2 m over the 10 m of the radial axis
+constexpr auto HEATMAP_AZIMUTH_BINS = 72;   // 5° over the full circle
+
+struct HeatmapSettings_t
+{
+    bool enabled;
+    double half_life;       // Seconds until a detection counts half
+};
+
+struct HeatmapCell_t
+{
+    float value;            // Decayed until updated_ns
+    qint64 updated_ns;
+};
+
+// How often targets were detected where, as polar grid below the targets of the polar chart. Detections
+// decay exponentially, but lazily: a cell is only decayed when it gets a new detection or is drawn, so
+// an update costs one cell per target regardless of the size of the grid.
+class OccupancyHeatmap : public QGraphicsItem
+{
+public:
+    OccupancyHeatmap(QChart *chart, QAbstractSeries *series);
+
+    void setSettings(HeatmapSettings_t const & settings);
+    void addTargets(Targets_t const & targets);
+    void clear();
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, QStyleOptionGraphicsItem const *option, QWidget *widget) override;
+
+private:
+    float decayed(HeatmapCell_t const & cell, qint64 now) const;
+
+private:
+    QChart *m_chart;
+    QAbstractSeries *m_series;
+    HeatmapSettings_t m_settings;
+    std::array<HeatmapCell_t, HEATMAP_RADIUS_BINS * HEATMAP_AZIMUTH_BINS> m_cells;
+};
+
+#endif // OCCUPANCYHEATMAP_H
@@ -1,16 +1,38 @@
 #include "targetdatachart.h"
 
-TargetDataChart::TargetDataChart()
+#include <logic/metrics/latencymetrics.h>
+#include <logic/metrics/tracerecorder.h>
+
+TargetDataChart::TargetDataChart() : m_heatmap(this, &m_target_data_series), m_trails(this, &m_target_data_series)
 {
+    m_paused = false;
     initialize();
 }
 
 void TargetDataChart::update(const Targets_t &data)
 {
+    LatencyScope scope(LatencyStage_t::ChartUpdate);
+    TraceScope trace("TargetDataChart::update");
+
     m_target_data_series.clear();
 
     for (auto & e: data)
         m_target_data_series.append(QPointF(e.azimuth, e.radius/100));
+
+    m_trails.addTargets(data);
+    if (!m_paused)
+        m_heatmap.addTargets(data);
+}
+
+void TargetDataChart::setHeatmapSettings(const HeatmapSettings_t &settings)
+{
+    m_heatmap.setSettings(settings);
+}
+
+void TargetDataChart::setPaused(bool paused)
+{
+    m_paused = paused;
+    m_trails.clear();
 }
 
 void TargetDataChart::initialize()
@@ -1,6 +1,8 @@
 #ifndef TARGETDATACHART_H
 #define TARGETDATACHART_H
 
+#include <gui/chart/targetdata/occupancyheatmap.h>
+#include <gui/chart/targetdata/targettrails.h>
 #include <misc/types.h>
 
 #include <QtCharts>
@@ -14,15 +16,23 @@ class TargetDataChart : public QPolarChart
 public:
     TargetDataChart();
 
+    void setHeatmapSettings(HeatmapSettings_t const & settings);
+
 public slots:
     void update(Targets_t const & data);
 
+    // While paused, browsed targets neither extend the trails of the live ones nor count into the heatmap
+    void setPaused(bool paused);
+
 private:
     void initialize();
     void setFontSize(size_t size);
 
 private:
     QScatterSeries m_target_data_series;
+    OccupancyHeatmap m_heatmap;
+    TargetTrails m_trails;
+    bool m_paused;
 };
 
 #endif // TARGETDATACHART_H
@@ -0,0 +1,100 @@
+#include "targettrails.h"
+
+#include <QPainter>
+
+// Constants
+constexpr auto TARGET_TRAIL_Z_VALUE = 10;   // Above all series of the chart
+constexpr auto TARGET_TRAIL_LINE_WIDTH = 3;
+
+TargetTrails::TargetTrails(QChart *chart, QAbstractSeries *series) : QGraphicsItem(chart), m_trails()
+{
+    m_chart = chart;
+    m_series = series;
+
+    // Positions stamped with 0 count as expired from the start
+    m_update = TARGET_TRAIL_LENGTH;
+
+    setZValue(TARGET_TRAIL_Z_VALUE);
+    QObject::connect(chart, &QChart::plotAreaChanged, chart, [this](QRectF const &) { prepareGeometryChange(); });
+}
+
+void TargetTrails::addTargets(const Targets_t &targets)
+{
+    m_update++;
+
+    for (auto const & target : targets)
+    {
+        auto & t = trail(target.target_id);
+        t.head = (t.head + 1) % TARGET_TRAIL_LENGTH;
+        t.positions[t.head] = QPointF(target.azimuth, target.radius / 100);
+        t.updates[t.head] = m_update;
+        t.last_update = m_update;
+    }
+
+    update();
+}
+
+void TargetTrails::clear()
+{
+    // Ages all positions beyond the trail length at once
+    m_update += TARGET_TRAIL_LENGTH;
+    update();
+}
+
+QRectF TargetTrails::boundingRect() const
+{
+    return m_chart->plotArea();
+}
+
+void TargetTrails::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option)
+    Q_UNUSED(widget)
+
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setClipRect(m_chart->plotArea());
+
+    QPen pen(Qt::white, TARGET_TRAIL_LINE_WIDTH, Qt::SolidLine, Qt::RoundCap);
+    for (auto const & t : m_trails)
+    {
+        if (m_update - t.last_update >= TARGET_TRAIL_LENGTH)
+            continue;
+
+        // Walk back from the newest position until the positions get too old
+        auto index = t.head;
+        auto previous = m_chart->mapToPosition(t.positions[index], m_series);
+        for (auto i = 1; i < TARGET_TRAIL_LENGTH; i++)
+        {
+            index = (index + TARGET_TRAIL_LENGTH - 1) % TARGET_TRAIL_LENGTH;
+            auto age = m_update - t.updates[index];
+            if (t.updates[index] < t.first_update || age >= TARGET_TRAIL_LENGTH)
+                break;
+
+            auto position = m_chart->mapToPosition(t.positions[index], m_series);
+            auto color = pen.color();
+            color.setAlpha(255 * (TARGET_TRAIL_LENGTH - age) / TARGET_TRAIL_LENGTH);
+            pen.setColor(color);
+            painter->setPen(pen);
+            painter->drawLine(previous, position);
+            previous = position;
+        }
+    }
+}
+
+TargetTrail_t &TargetTrails::trail(uint32_t target_id)
+{
+    auto oldest = &m_trails.front();
+    for (auto & t : m_trails)
+    {
+        if (t.target_id == target_id && m_update - t.last_update < TARGET_TRAIL_LENGTH)
+            return t;
+
+        if (t.last_update < oldest->last_update)
+            oldest = &t;
+    }
+
+    // Take over the track updated longest ago, its positions are left behind
+    oldest->target_id = target_id;
+    oldest->first_update = m_update;
+    return *oldest;
+}
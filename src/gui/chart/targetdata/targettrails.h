@@ -0,0 +1,51 @@
+#ifndef TARGETTRAILS_H
+#define TARGETTRAILS_H
+
+#include <misc/types.h>
+
+#include <QGraphicsItem>
+#include <QtCharts>
+#include <array>
+
+using namespace QtCharts;
+
+// Constants
+constexpr auto TARGET_TRAIL_LENGTH = 32;    // Positions per track, also the age in updates after which they vanish
+constexpr auto TARGET_TRAIL_TRACKS = 16;
+
+struct TargetTrail_t
+{
+    uint32_t target_id;
+    quint64 first_update;                                   // Positions before belong to a previous target id
+    quint64 last_update;
+    int head;                                               // Index of the newest position
+    std::array<QPointF, TARGET_TRAIL_LENGTH> positions;     // Azimuth and radius
+    std::array<quint64, TARGET_TRAIL_LENGTH> updates;       // Update counter at each position
+};
+
+// Fading trails of the recent target positions, drawn on top of a polar chart. Every track owns a fixed
+// ring of positions; positions age implicitly by comparing their update counter with the current one,
+// so nothing has to be touched per update except the rings of the current targets. Tracks not updated
+// for a whole trail length are reused for new target ids.
+class TargetTrails : public QGraphicsItem
+{
+public:
+    TargetTrails(QChart *chart, QAbstractSeries *series);
+
+    void addTargets(Targets_t const & targets);
+    void clear();
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, QStyleOptionGraphicsItem const *option, QWidget *widget) override;
+
+private:
+    TargetTrail_t & trail(uint32_t target_id);
+
+private:
+    QChart *m_chart;
+    QAbstractSeries *m_series;
+    quint64 m_update;
+    std::array<TargetTrail_t, TARGET_TRAIL_TRACKS> m_trails;
+};
+
+#endif // TARGETTRAILS_H
@@ -1,66 +1,32 @@
 #include "timedatachart.h"
 
-#include <QFont>
+#include <logic/metrics/tracerecorder.h>
 
-TimeDataChart::TimeDataChart()
+TimeDataChart::TimeDataChart(QWidget *parent) : PlotWidget(parent)
 {
     initialize();
 }
 
-void TimeDataChart::update(const DataPoints_t &re_rx1, const DataPoints_t &im_rx1, const DataPoints_t &re_rx2, const DataPoints_t &im_rx2)
+void TimeDataChart::setData(const DataPoints_t &re_rx1, const DataPoints_t &im_rx1, const DataPoints_t &re_rx2, const DataPoints_t &im_rx2)
 {
-    m_time_data_series_re_rx1.clear();
-    m_time_data_series_im_rx1.clear();
-    m_time_data_series_re_rx2.clear();
-    m_time_data_series_im_rx2.clear();
+    TraceScope trace("TimeDataChart::setData");
 
-    m_time_data_series_re_rx1.append(re_rx1);
-    m_time_data_series_im_rx1.append(im_rx1);
-    m_time_data_series_re_rx2.append(re_rx2);
-    m_time_data_series_im_rx2.append(im_rx2);
+    setCurve(m_time_data_series_re_rx1, re_rx1);
+    setCurve(m_time_data_series_im_rx1, im_rx1);
+    setCurve(m_time_data_series_re_rx2, re_rx2);
+    setCurve(m_time_data_series_im_rx2, im_rx2);
 }
 
 void TimeDataChart::initialize()
 {
+    m_time_data_series_re_rx1 = addCurve("Inphase antenna 1", QColor(0xc7, 0xe8, 0x5b));
+    m_time_data_series_im_rx1 = addCurve("Quadrature antenna 1", QColor(0x1c, 0xb5, 0x4f));
+    m_time_data_series_re_rx2 = addCurve("Inphase antenna 2", QColor(0x5c, 0xbf, 0x9b));
+    m_time_data_series_im_rx2 = addCurve("Quadrature antenna 2", QColor(0x00, 0x9f, 0xbf));
 
-    m_time_data_series_re_rx1.setName("Inphase signal<br>component antenna 1");
-    m_time_data_series_im_rx1.setName("Quadratur signal<br>component antenna 1");
-    m_time_data_series_re_rx2.setName("Inphase signal<br>component antenna 2");
-    m_time_data_series_im_rx2.setName("Quadratur signal<br>component antenna 2");
-
-    setTheme(QChart::ChartThemeBlueCerulean);
     setTitle("Time domain");
-    addSeries(&m_time_data_series_re_rx1);
-    addSeries(&m_time_data_series_im_rx1);
-    addSeries(&m_time_data_series_re_rx2);
-    addSeries(&m_time_data_series_im_rx2);
-
-    auto axisX = new QValueAxis();
-    axisX->setTitleText("Samples");
-    axisX->setRange(0, 63);
-    axisX->setLabelFormat("%d");
-    addAxis(axisX, Qt::AlignBottom);
-    m_time_data_series_re_rx1.attachAxis(axisX);
-    m_time_data_series_im_rx1.attachAxis(axisX);
-    m_time_data_series_re_rx2.attachAxis(axisX);
-    m_time_data_series_im_rx2.attachAxis(axisX);
-
-    auto axisY = new QValueAxis();
-    axisY->setTitleText("Amplitude");
-    axisY->setRange(0, 1.2);
-    axisY->setLabelFormat("%.1f");
-    addAxis(axisY, Qt::AlignLeft);
-    m_time_data_series_re_rx1.attachAxis(axisY);
-    m_time_data_series_im_rx1.attachAxis(axisY);
-    m_time_data_series_re_rx2.attachAxis(axisY);
-    m_time_data_series_im_rx2.attachAxis(axisY);
-
-    setFontSize(20);
-}
-
-void TimeDataChart::setFontSize(size_t size)
-{
-    QFont font;
-    font.setPixelSize(size);
-    setTitleFont(font);
+    setAxisTitles("Samples", "Amplitude");
+    setAxisPrecision(0, 1);
+    setXRange(0, 63);
+    setYRange(0, 1.2);
 }
@@ -1,31 +1,27 @@
 #ifndef TIMEDATACHART_H
 #define TIMEDATACHART_H
 
+#include <gui/chart/plot/plotwidget.h>
 #include <misc/types.h>
 
-#include <QtCharts>
-
-using namespace QtCharts;
-
-class TimeDataChart : public QChart
+class TimeDataChart : public PlotWidget
 {
     Q_OBJECT
 
 public:
-    TimeDataChart();
+    explicit TimeDataChart(QWidget *parent = nullptr);
 
 public slots:
-    void update(DataPoints_t const & re_rx1, DataPoints_t const & im_rx1,
-                DataPoints_t const & re_rx2, DataPoints_t const & im_rx2);
+    void setData(DataPoints_t const & re_rx1, DataPoints_t const & im_rx1,
+                 DataPoints_t const & re_rx2, DataPoints_t const & im_rx2);
 private:
     void initialize();
-    void setFontSize(size_t size);
 
 private:
-    QLineSeries m_time_data_series_re_rx1;
-    QLineSeries m_time_data_series_im_rx1;
-    QLineSeries m_time_data_series_re_rx2;
-    QLineSeries m_time_data_series_im_rx2;
+    int m_time_data_series_re_rx1;
+    int m_time_data_series_im_rx1;
+    int m_time_data_series_re_rx2;
+    int m_time_data_series_im_rx2;
 };
 
 #endif // TIMEDATACHART_H
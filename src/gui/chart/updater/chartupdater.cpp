@@ -0,0 +1,106 @@
+#include "chartupdater.h"
+
+#include <gui/chart/rangedata/rangedatachart.h>
+#include <gui/chart/targetdata/targetdatachart.h>
+#include <gui/chart/timedata/timedatachart.h>
+#include <gui/chart/waterfall/waterfallchart.h>
+#include <logic/metrics/telemetry.h>
+
+#include <QDebug>
+#include <QGuiApplication>
+#include <QScreen>
+
+// Constants
+constexpr auto CHART_DEFAULT_REFRESH_RATE = 60.0;
+
+ChartUpdater::ChartUpdater(TimeDataChart *timedata, RangeDataChart *rangedata, TargetDataChart *targetdata, QObject *parent) : QObject(parent)
+{
+    m_timedata = timedata;
+    m_rangedata = rangedata;
+    m_targetdata = targetdata;
+    m_waterfall = nullptr;
+    m_paused = false;
+    m_frames_shown = 0;
+    m_frames_skipped = 0;
+
+    m_timer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&m_timer, &QTimer::timeout, this, &ChartUpdater::refresh);
+}
+
+ChartUpdater::~ChartUpdater()
+{
+    if (m_timer.isActive())
+        qInfo() << "Charts:" << m_frames_shown << "frames shown," << m_frames_skipped << "frames skipped.";
+}
+
+void ChartUpdater::setWaterfall(WaterfallChart *waterfall)
+{
+    m_waterfall = waterfall;
+}
+
+void ChartUpdater::start()
+{
+    auto rate = CHART_DEFAULT_REFRESH_RATE;
+    auto screen = QGuiApplication::primaryScreen();
+    if (screen != nullptr && screen->refreshRate() > 0.0)
+        rate = screen->refreshRate();
+
+    m_timer.start(qRound(1000.0 / rate));
+    qInfo() << "Updating charts at" << rate << "Hz.";
+}
+
+ChartUpdaterStatistics_t ChartUpdater::statistics() const
+{
+    ChartUpdaterStatistics_t s;
+    s.frames_shown = m_frames_shown;
+    s.frames_skipped = m_frames_skipped;
+    return s;
+}
+
+void ChartUpdater::setPaused(bool paused)
+{
+    m_paused = paused;
+}
+
+void ChartUpdater::updateTimeData(const DataPoints_t &re_rx1, const DataPoints_t &im_rx1, const DataPoints_t &re_rx2, const DataPoints_t &im_rx2)
+{
+    m_timedata_mailbox.put({re_rx1, im_rx1, re_rx2, im_rx2});
+}
+
+void ChartUpdater::updateRangeData(const DataPoints_t &rx1, const DataPoints_t &rx2, const DataPoints_t &maxima, const double &max_y, qint64 timestamp_ns)
+{
+    if (m_waterfall != nullptr)
+        m_waterfall->addProfile(rx1, timestamp_ns);
+
+    if (!m_rangedata_mailbox.put({rx1, rx2, maxima, max_y, timestamp_ns}))
+    {
+        m_frames_skipped.fetch_add(1, std::memory_order_relaxed);
+        Telemetry::instance().guiFrameSkipped();
+    }
+}
+
+void ChartUpdater::updateTargetData(const Targets_t &targets)
+{
+    m_targetdata_mailbox.put(targets);
+}
+
+void ChartUpdater::refresh()
+{
+    if (m_waterfall != nullptr)
+        m_waterfall->refresh();
+
+    if (m_paused)
+        return;
+
+    if (auto t = m_timedata_mailbox.take())
+        m_timedata->setData(t->re_rx1, t->im_rx1, t->re_rx2, t->im_rx2);
+
+    if (auto r = m_rangedata_mailbox.take())
+    {
+        m_rangedata->setData(r->rx1, r->rx2, r->maxima, r->max_y, r->timestamp_ns);
+        m_frames_shown.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (auto t = m_targetdata_mailbox.take())
+        m_targetdata->update(*t);
+}
@@ -0,0 +1,80 @@
+#ifndef CHARTUPDATER_H
+#define CHARTUPDATER_H
+
+#include <misc/mailbox.h>
+#include <misc/types.h>
+
+#include <QObject>
+#include <QTimer>
+#include <atomic>
+
+class TimeDataChart;
+class RangeDataChart;
+class TargetDataChart;
+class WaterfallChart;
+
+struct TimeDataUpdate_t
+{
+    DataPoints_t re_rx1;
+    DataPoints_t im_rx1;
+    DataPoints_t re_rx2;
+    DataPoints_t im_rx2;
+};
+
+struct RangeDataUpdate_t
+{
+    DataPoints_t rx1;
+    DataPoints_t rx2;
+    DataPoints_t maxima;
+    double max_y;
+    qint64 timestamp_ns;
+};
+
+struct ChartUpdaterStatistics_t
+{
+    quint64 frames_shown;
+    quint64 frames_skipped;     // Range data overwritten before it was shown
+};
+
+// Decouples the acquisition rate from the render rate: the pipeline puts its results into a latest-value
+// mailbox per chart from the acquisition thread, and a timer running at the refresh rate of the screen
+// updates each chart with the newest value only. Values arriving faster are skipped instead of queued.
+class ChartUpdater : public QObject
+{
+    Q_OBJECT
+
+public:
+    ChartUpdater(TimeDataChart *timedata, RangeDataChart *rangedata, TargetDataChart *targetdata, QObject *parent = nullptr);
+    ~ChartUpdater();
+
+    void setWaterfall(WaterfallChart *waterfall);
+    void start();
+    ChartUpdaterStatistics_t statistics() const;
+
+public slots:
+    // While paused, the charts keep showing what they show and only the waterfall continues
+    void setPaused(bool paused);
+
+    // Called from the acquisition thread
+    void updateTimeData(DataPoints_t const & re_rx1, DataPoints_t const & im_rx1, DataPoints_t const & re_rx2, DataPoints_t const & im_rx2);
+    void updateRangeData(DataPoints_t const & rx1, DataPoints_t const & rx2, DataPoints_t const & maxima, double const & max_y, qint64 timestamp_ns);
+    void updateTargetData(Targets_t const & targets);
+
+private slots:
+    void refresh();
+
+private:
+    TimeDataChart *m_timedata;
+    RangeDataChart *m_rangedata;
+    TargetDataChart *m_targetdata;
+    WaterfallChart *m_waterfall;
+    Mailbox<TimeDataUpdate_t> m_timedata_mailbox;
+    Mailbox<RangeDataUpdate_t> m_rangedata_mailbox;
+    Mailbox<Targets_t> m_targetdata_mailbox;
+    QTimer m_timer;
+    bool m_paused;
+    std::atomic<quint64> m_frames_shown;
+    std::atomic<quint64> m_frames_skipped;
+};
+
+#endif // CHARTUPDATER_H
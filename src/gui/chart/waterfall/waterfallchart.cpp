@@ -0,0 +1,256 @@
+#include "waterfallchart.h"
+
+#include <logic/metrics/tracerecorder.h>
+#include <misc/clock.h>
+
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+// Constants
+constexpr auto WATERFALL_QUEUE_CAPACITY = 256;
+constexpr auto WATERFALL_LUT_SIZE = 256;
+constexpr auto WATERFALL_STALL_PERIODS = 3;     // Row periods without a row until empty rows scroll in
+
+// Colormap from low to high magnitude, interpolated into the lookup table
+constexpr QRgb WATERFALL_COLORMAP[] = {
+    0xff000004, 0xff3b0f70, 0xff8c2981, 0xffde4968, 0xfffe9f6d, 0xfffcfdbf
+};
+
+WaterfallChart::WaterfallChart(QWidget *parent) : PlotWidget(parent), m_rows(WATERFALL_QUEUE_CAPACITY)
+{
+    m_peak_min_range = 0.0;
+    m_peak_max_range = 0.0;
+    m_min_range = 0.0;
+    m_max_range = 0.0;
+    m_row_begin_ns = 0;
+    m_restart = false;
+    m_rows_dropped = 0;
+    m_rows_pending = false;
+    m_clock_offset_ns = 0;
+    m_last_refresh_ns = 0;
+    m_row = 0;
+    m_newest_begin_ns = 0;
+
+    setSettings({true, 30.0, 20, -60.0, 0.0});
+
+    setTitle("Range over time (antenna 1)");
+    setAxisTitles("Range [m]", "Age [s]");
+    setAxisPrecision(1, 0);
+}
+
+WaterfallChart::~WaterfallChart()
+{
+    stopRendering();
+
+    if (m_rows_dropped > 0)
+        qWarning() << "Waterfall:" << m_rows_dropped << "rows dropped.";
+}
+
+void WaterfallChart::setSettings(const WaterfallSettings_t &settings)
+{
+    m_settings = settings;
+    m_settings.rows_per_second = qMax(m_settings.rows_per_second, 1u);
+    m_row_period_ns = 1000000000 / m_settings.rows_per_second;
+
+    generateLut();
+    setYRange(0, m_settings.duration);
+    m_image = QImage();
+}
+
+void WaterfallChart::addProfile(const DataPoints_t &rx1, qint64 timestamp_ns)
+{
+    if (rx1.isEmpty())
+        return;
+
+    // Start a new row on the first profile and when a replay jumps back
+    auto elapsed = timestamp_ns - m_row_begin_ns;
+    if (m_row_begin_ns == 0 || elapsed < 0)
+    {
+        m_restart = m_row_begin_ns != 0;
+        m_row_begin_ns = timestamp_ns;
+        std::fill(m_peak.begin(), m_peak.end(), 0.0f);
+        elapsed = 0;
+    }
+
+    if (elapsed >= m_row_period_ns)
+    {
+        // Row periods without any profile are filled with empty rows by the render thread
+        pushRow();
+        m_row_begin_ns += elapsed / m_row_period_ns * m_row_period_ns;
+    }
+
+    m_clock_offset_ns.store(monotonicTimestamp() - timestamp_ns, std::memory_order_relaxed);
+
+    if (m_peak.size() != static_cast<size_t>(rx1.size()))
+        m_peak.assign(rx1.size(), 0.0f);
+
+    auto peak = m_peak.data();
+    for (auto const & point : rx1)
+    {
+        *peak = std::max(*peak, static_cast<float>(point.y()));
+        peak++;
+    }
+
+    m_peak_min_range = rx1.front().x();
+    m_peak_max_range = rx1.back().x();
+}
+
+void WaterfallChart::refresh()
+{
+    // Without new rows the chart is still rendered once per row period, so it scrolls on while the
+    // acquisition stalls
+    auto now = monotonicTimestamp();
+    if (!m_rows_pending.exchange(false) && now - m_last_refresh_ns < m_row_period_ns)
+        return;
+
+    m_last_refresh_ns = now;
+    setXRange(m_min_range, m_max_range);
+    scheduleRender();
+}
+
+void WaterfallChart::renderPlotArea(QPainter &painter, const QRectF &area)
+{
+    while (auto row = m_rows.front())
+    {
+        writeRow(*row);
+        m_rows.pop();
+    }
+
+    if (m_image.isNull())
+        return;
+
+    // Rows are pushed with the first profile of the next period, only a longer gap means a stall
+    auto now = monotonicTimestamp() - m_clock_offset_ns.load(std::memory_order_relaxed);
+    auto missing = (now - m_newest_begin_ns) / m_row_period_ns - WATERFALL_STALL_PERIODS;
+    if (missing > 0)
+        advanceRows(missing);
+
+    // The oldest rows follow the newest one in the image and are drawn at the top
+    auto rows = m_image.height();
+    auto row_height = area.height() / rows;
+    auto older = rows - 1 - m_row;
+    if (older > 0)
+    {
+        painter.drawImage(QRectF(area.left(), area.top(), area.width(), older * row_height),
+                          m_image, QRectF(0, m_row + 1, m_image.width(), older));
+    }
+
+    painter.drawImage(QRectF(area.left(), area.top() + older * row_height, area.width(), (m_row + 1) * row_height),
+                      m_image, QRectF(0, 0, m_image.width(), m_row + 1));
+}
+
+void WaterfallChart::pushRow()
+{
+    auto row = m_rows.acquire();
+    if (row == nullptr)
+    {
+        m_rows_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    row->begin_ns = m_row_begin_ns;
+    row->restart = m_restart;
+    row->magnitudes.assign(m_peak.begin(), m_peak.end());
+    m_restart = false;
+
+    m_min_range = m_peak_min_range;
+    m_max_range = m_peak_max_range;
+    m_rows.commit();
+    m_rows_pending = true;
+
+    std::fill(m_peak.begin(), m_peak.end(), 0.0f);
+}
+
+void WaterfallChart::writeRow(const WaterfallRow_t &row)
+{
+    TraceScope trace("WaterfallChart::writeRow");
+
+    auto width = static_cast<int>(row.magnitudes.size());
+    if (width == 0)
+        return;
+
+    // Rows are placed by their time: gaps are filled with empty rows and a row arriving after empty rows
+    // were scrolled in for its period replaces its empty row
+    auto rows = m_image.height();
+    auto periods = qRound64(static_cast<double>(row.begin_ns - m_newest_begin_ns) / m_row_period_ns);
+    if (m_image.width() != width || row.restart || periods <= -rows)
+    {
+        resetImage(width);
+        m_newest_begin_ns = row.begin_ns - m_row_period_ns;
+        periods = 1;
+        rows = m_image.height();
+    }
+
+    if (periods > 0)
+    {
+        advanceRows(periods);
+        writeLine(m_row, row.magnitudes);
+    }
+    else
+    {
+        writeLine(static_cast<int>((m_row + periods + rows) % rows), row.magnitudes);
+    }
+}
+
+void WaterfallChart::writeLine(int line, const std::vector<float> &magnitudes)
+{
+    auto pixels = reinterpret_cast<QRgb*>(m_image.scanLine(line));
+    auto width = std::min(static_cast<int>(magnitudes.size()), m_image.width());
+    for (auto i = 0; i < width; i++)
+    {
+        auto magnitude = magnitudes[i];
+        auto db = magnitude > 0.0f ? 20.0 * std::log10(magnitude) : m_settings.min_db;
+        auto index = static_cast<int>((db - m_settings.min_db) * m_lut_scale);
+        pixels[i] = m_lut[qBound(0, index, WATERFALL_LUT_SIZE - 1)];
+    }
+}
+
+void WaterfallChart::advanceRows(qint64 count)
+{
+    auto rows = m_image.height();
+    m_newest_begin_ns += count * m_row_period_ns;
+
+    if (count >= rows)
+    {
+        m_image.fill(m_lut.front());
+        m_row = static_cast<int>((m_row + count) % rows);
+        return;
+    }
+
+    for (auto i = 0; i < count; i++)
+    {
+        m_row = (m_row + 1) % rows;
+        auto pixels = reinterpret_cast<QRgb*>(m_image.scanLine(m_row));
+        std::fill(pixels, pixels + m_image.width(), m_lut.front());
+    }
+}
+
+void WaterfallChart::resetImage(int width)
+{
+    auto rows = qMax(1, qRound(m_settings.duration * m_settings.rows_per_second));
+    m_image = QImage(width, rows, QImage::Format_RGB32);
+    m_image.fill(m_lut.front());
+    m_row = rows - 1;
+}
+
+void WaterfallChart::generateLut()
+{
+    constexpr auto stops = sizeof(WATERFALL_COLORMAP) / sizeof(WATERFALL_COLORMAP[0]) - 1;
+
+    m_lut.resize(WATERFALL_LUT_SIZE);
+    for (auto i = 0; i < WATERFALL_LUT_SIZE; i++)
+    {
+        auto position = static_cast<double>(i) / (WATERFALL_LUT_SIZE - 1) * stops;
+        auto stop = std::min(static_cast<size_t>(position), stops - 1);
+        auto t = position - stop;
+        auto a = WATERFALL_COLORMAP[stop];
+        auto b = WATERFALL_COLORMAP[stop + 1];
+        m_lut[i] = qRgb(qRound(qRed(a) + t * (qRed(b) - qRed(a))),
+                        qRound(qGreen(a) + t * (qGreen(b) - qGreen(a))),
+                        qRound(qBlue(a) + t * (qBlue(b) - qBlue(a))));
+    }
+
+    auto range = m_settings.max_db - m_settings.min_db;
+    m_lut_scale = range > 0.0 ? (WATERFALL_LUT_SIZE - 1) / range : 0.0;
+}
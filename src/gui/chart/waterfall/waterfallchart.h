@@ -0,0 +1,90 @@
+#ifndef WATERFALLCHART_H
+#define WATERFALLCHART_H
+
+#include <gui/chart/plot/plotwidget.h>
+#include <misc/spscqueue.h>
+#include <misc/types.h>
+
+#include <QImage>
+#include <QVector>
+#include <atomic>
+#include <vector>
+
+struct WaterfallSettings_t
+{
+    bool enabled;
+    double duration;            // Seconds shown
+    quint32 rows_per_second;
+    double min_db;              // Magnitudes at or below are drawn with the first color of the colormap
+    double max_db;              // Magnitudes at or above are drawn with the last color of the colormap
+};
+
+struct WaterfallRow_t
+{
+    qint64 begin_ns;                // Timestamp at which the row period began
+    bool restart;                   // Timestamps jumped back, e.g. a replay started over
+    std::vector<float> magnitudes;
+};
+
+// Range spectrum of antenna 1 over the last seconds. All profiles arriving within one row period are
+// combined by their maximum, so short events are not lost. Rows are written into a circular image through
+// a colormap lookup table and the image is drawn in two parts split at the newest row, so no pixel data
+// ever moves. Completed rows are written into the image on the render thread of the plot, which also fills
+// row periods without any profile with empty rows, so the chart keeps scrolling while the acquisition stalls.
+class WaterfallChart : public PlotWidget
+{
+    Q_OBJECT
+
+public:
+    explicit WaterfallChart(QWidget *parent = nullptr);
+    ~WaterfallChart();
+
+    // Before the chart is shown
+    void setSettings(WaterfallSettings_t const & settings);
+
+    // Called from the acquisition thread
+    void addProfile(DataPoints_t const & rx1, qint64 timestamp_ns);
+
+    // Called from the GUI thread, renders the chart if rows were completed or a row period passed
+    void refresh();
+
+protected:
+    void renderPlotArea(QPainter & painter, QRectF const & area) override;
+
+private:
+    void pushRow();
+    void writeRow(WaterfallRow_t const & row);
+    void writeLine(int line, std::vector<float> const & magnitudes);
+    void advanceRows(qint64 count);
+    void resetImage(int width);
+    void generateLut();
+
+private:
+    WaterfallSettings_t m_settings;
+    qint64 m_row_period_ns;
+
+    // Acquisition thread
+    std::vector<float> m_peak;
+    double m_peak_min_range;
+    double m_peak_max_range;
+    qint64 m_row_begin_ns;
+    bool m_restart;
+    SpscQueue<WaterfallRow_t> m_rows;
+    std::atomic<quint64> m_rows_dropped;
+    std::atomic<bool> m_rows_pending;
+    std::atomic<qint64> m_clock_offset_ns;  // Monotonic time minus the timestamp of the latest profile
+    std::atomic<double> m_min_range;
+    std::atomic<double> m_max_range;
+
+    // GUI thread
+    qint64 m_last_refresh_ns;
+
+    // Render thread
+    QVector<QRgb> m_lut;
+    double m_lut_scale;
+    QImage m_image;
+    int m_row;
+    qint64 m_newest_begin_ns;
+};
+
+#endif // WATERFALLCHART_H
@@ -9,6 +9,8 @@ Dashboard::Dashboard(QWidget *parent): QMainWindow(parent), ui(new Ui::Dashboard
     m_statusbar = nullptr;
     m_toolbar = nullptr;
     m_settings = nullptr;
+    m_shown = false;
+    ui->waterfall->hide();
     resize(QDesktopWidget().availableGeometry(this).size() * 0.75);
 }
 
@@ -50,25 +52,90 @@ void Dashboard::setChart(QChart *chart, ChartType_t type)
     if (chart == nullptr)
         return;
 
-    QChartView * v = nullptr;
+    if (type != ChartType_t::TargetData)
+        return;
+
+    QChartView * v = ui->target_data;
+    v->setChart(chart);
+    v->setRenderHint(QPainter::Antialiasing);
+    v->chart()->layout()->setContentsMargins(0, 0, 0, 0);
+    v->chart()->setBackgroundRoundness(0);
+    v->show();
+}
+
+void Dashboard::setPlot(QWidget *plot, ChartType_t type)
+{
+    if (plot == nullptr)
+        return;
+
+    QWidget * container = nullptr;
     switch(type)
     {
         case ChartType_t::TimeData:
-            v = ui->time_data;
+            container = ui->time_data;
             break;
         case ChartType_t::RangeData:
-            v = ui->range_data;
+            container = ui->range_data;
             break;
-        case ChartType_t::TargetData:
-            v = ui->target_data;
+        case ChartType_t::Waterfall:
+            container = ui->waterfall;
             break;
+        case ChartType_t::TargetData:
+            return;
     }
 
-    v->setChart(chart);
-    v->setRenderHint(QPainter::Antialiasing);
-    v->chart()->layout()->setContentsMargins(0, 0, 0, 0);
-    v->chart()->setBackgroundRoundness(0);
-    v->show();
+    container->layout()->addWidget(plot);
+    container->show();
+    plot->show();
+}
+
+void Dashboard::setTimeline(Timeline *timeline)
+{
+    if (timeline == nullptr)
+        return;
+
+    ui->verticalLayout->addWidget(timeline);
+    timeline->setVisible(true);
+}
+
+void Dashboard::setHud(Hud *hud)
+{
+    if (hud == nullptr)
+        return;
+
+    // Floats over the top left corner of the charts, outside of any layout
+    hud->setParent(ui->centralwidget);
+    hud->move(0, 0);
+    hud->raise();
+}
+
+void Dashboard::changeEvent(QEvent *event)
+{
+    QMainWindow::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange)
+        updateShown();
+}
+
+void Dashboard::showEvent(QShowEvent *event)
+{
+    QMainWindow::showEvent(event);
+    updateShown();
+}
+
+void Dashboard::hideEvent(QHideEvent *event)
+{
+    QMainWindow::hideEvent(event);
+    updateShown();
+}
+
+void Dashboard::updateShown()
+{
+    auto shown = isVisible() && !isMinimized();
+    if (shown == m_shown)
+        return;
+
+    m_shown = shown;
+    emit shownChanged(shown);
 }
 
 #ifdef _WIN32
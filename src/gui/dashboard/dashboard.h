@@ -2,8 +2,10 @@
 #define DASHBOARD_H
 
 #include <misc/types.h>
+#include <gui/hud/hud.h>
 #include <gui/settings/settings.h>
 #include <gui/statusbar/statusbar.h>
+#include <gui/timeline/timeline.h>
 #include <gui/toolbar/toolbar.h>
 
 #include <EndpointRadarBase.h>
@@ -27,6 +29,9 @@ public:
     void setToolbar(ToolBar *toolbar);
     void setSettings(Settings *settings);
     void setChart(QtCharts::QChart *chart, ChartType_t type);
+    void setPlot(QWidget *plot, ChartType_t type);
+    void setTimeline(Timeline *timeline);
+    void setHud(Hud *hud);
 
 public slots:
 #ifdef _WIN32
@@ -36,10 +41,22 @@ public slots:
 signals:
     void closed();
 
+    // The window became visible and not minimized, or hidden or minimized
+    void shownChanged(bool shown);
+
+protected:
+    void changeEvent(QEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void updateShown();
+
 private:
     Ui::Dashboard *ui;
     StatusBar *m_statusbar;
     ToolBar *m_toolbar;
     Settings *m_settings;
+    bool m_shown;
 };
 #endif // DASHBOARD_H
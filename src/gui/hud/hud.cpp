@@ -0,0 +1,104 @@
+#include "hud.h"
+
+#include <QFontDatabase>
+
+// Constants
+constexpr auto HUD_SAMPLE_INTERVAL = 1000;
+constexpr auto HUD_MARGIN = 8;
+const QColor HUD_BACKGROUND_COLOR(0x00, 0x00, 0x00, 0xa0);
+const QColor HUD_TEXT_COLOR(Qt::white);
+
+static QString formatLatency(qint64 latency_ns)
+{
+    return QString("%1 ms").arg(latency_ns / 1e6, 6, 'f', 1);
+}
+
+Hud::Hud(QWidget *parent) : QLabel(parent)
+{
+    m_snapshot = Telemetry::instance().snapshot();
+    m_latency_counts.fill(0);
+    m_latency_enabled = false;
+    m_latency_held = false;
+
+    auto palette = this->palette();
+    palette.setColor(QPalette::Window, HUD_BACKGROUND_COLOR);
+    palette.setColor(QPalette::WindowText, HUD_TEXT_COLOR);
+    setPalette(palette);
+    setAutoFillBackground(true);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setMargin(HUD_MARGIN);
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+
+    QObject::connect(&m_timer, &QTimer::timeout, this, &Hud::sample);
+    setText("Sampling...");
+    setVisible(false);
+}
+
+void Hud::showEvent(QShowEvent *event)
+{
+    QLabel::showEvent(event);
+
+    // The end-to-end latency is only measured with the latency metrics enabled, only while shown
+    if (!m_latency_held)
+    {
+        m_latency_enabled = LatencyMetrics::instance().isEnabled();
+        m_latency_held = true;
+        LatencyMetrics::instance().setEnabled(true);
+    }
+    LatencyMetrics::instance().histogram(LatencyStage_t::EndToEnd).counts(m_latency_counts);
+    m_snapshot = Telemetry::instance().snapshot();
+    m_elapsed.start();
+    m_timer.start(HUD_SAMPLE_INTERVAL);
+}
+
+void Hud::hideEvent(QHideEvent *event)
+{
+    QLabel::hideEvent(event);
+    m_timer.stop();
+
+    if (m_latency_held)
+    {
+        LatencyMetrics::instance().setEnabled(m_latency_enabled);
+        m_latency_held = false;
+    }
+}
+
+void Hud::sample()
+{
+    auto snapshot = Telemetry::instance().snapshot();
+    auto seconds = m_elapsed.restart() / 1000.0;
+    if (seconds <= 0.0)
+        return;
+
+    auto & latency = LatencyMetrics::instance();
+    LatencyHistogram::Counts_t latency_counts;
+    latency.histogram(LatencyStage_t::EndToEnd).counts(latency_counts);
+
+    auto rate = [seconds](quint64 current, quint64 previous) { return (current - previous) / seconds; };
+
+    QString latency_text = "n/a";
+    if (latency.isEndToEndEnabled())
+    {
+        latency_text = QString("p50 %1  p99 %2")
+                .arg(formatLatency(LatencyHistogram::percentile(latency_counts, m_latency_counts, 50.0)))
+                .arg(formatLatency(LatencyHistogram::percentile(latency_counts, m_latency_counts, 99.0)));
+    }
+
+    setText(QString("Acquisition %1 fps\n"
+                    "DSP         %2 fps\n"
+                    "Render      %3 fps\n"
+                    "Latency     %4\n"
+                    "Dropped     %5 missed, %6 skipped\n"
+                    "Serial      %7 kB/s")
+            .arg(rate(snapshot.frames_received, m_snapshot.frames_received), 6, 'f', 1)
+            .arg(rate(snapshot.frames_processed, m_snapshot.frames_processed), 6, 'f', 1)
+            .arg(rate(snapshot.gui_frames, m_snapshot.gui_frames), 6, 'f', 1)
+            .arg(latency_text)
+            .arg(snapshot.frames_missed)
+            .arg(snapshot.gui_frames_skipped)
+            .arg(rate(snapshot.serial_received_bytes, m_snapshot.serial_received_bytes) / 1000.0, 6, 'f', 1));
+    adjustSize();
+
+    m_snapshot = snapshot;
+    m_latency_counts = latency_counts;
+}
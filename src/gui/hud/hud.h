@@ -0,0 +1,42 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <logic/metrics/latencymetrics.h>
+#include <logic/metrics/telemetry.h>
+
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QTimer>
+
+struct HudSettings_t
+{
+    bool enabled;               // Shown at startup, F12 toggles it anyway
+};
+
+// Overlay with the frame rates of acquisition, processing and rendering, the end-to-end latency, dropped
+// frames and the serial throughput. Sampled once per second from the telemetry counters and the latency
+// histogram while shown, so it tells at a glance whether the link, the CPU or the display is the bottleneck.
+class Hud : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit Hud(QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void sample();
+
+private:
+    QTimer m_timer;
+    QElapsedTimer m_elapsed;
+    TelemetrySnapshot_t m_snapshot;
+    LatencyHistogram::Counts_t m_latency_counts;
+    bool m_latency_enabled;     // Whether the latency metrics were enabled before the HUD was shown
+    bool m_latency_held;
+};
+
+#endif // HUD_H
@@ -6,9 +6,13 @@ StatusBar::StatusBar(QWidget *parent) : QStatusBar(parent)
     m_firmware_version = "";
     m_serial_port = "";
     m_temperature = "";
+    m_command = "";
     m_connection_state = false;
     setSizeGripEnabled(false);
     setVisible(false);
+
+    m_latency.setVisible(false);
+    addPermanentWidget(&m_latency);
 }
 
 void StatusBar::updateFirmwareInformation(QString const & description, QString const & version)
@@ -36,6 +40,19 @@ void StatusBar::updateConnection(bool connected)
     showMessage(getStatus());
 }
 
+void StatusBar::updateLatency(const QString &summary, const QString &details)
+{
+    m_latency.setText(summary);
+    m_latency.setToolTip(details);
+    m_latency.setVisible(true);
+}
+
+void StatusBar::updateCommand(const QString &command, bool success)
+{
+    m_command = QString("%1: %2").arg(command).arg(success ? "OK" : "Failed");
+    showMessage(getStatus());
+}
+
 QString StatusBar::getStatus()
 {
     QString msg = "Status: ";
@@ -50,6 +67,9 @@ QString StatusBar::getStatus()
                     .arg(m_firmware_description)
                     .arg(m_firmware_version)
                     .arg(m_temperature));
+
+        if (!m_command.isEmpty())
+            msg.append("  |  " + m_command);
     }
     return msg;
 }
@@ -1,6 +1,7 @@
 #ifndef STATUSBAR_H
 #define STATUSBAR_H
 
+#include <QLabel>
 #include <QStatusBar>
 
 class StatusBar : public QStatusBar
@@ -15,6 +16,8 @@ public slots:
     void updateSerialPort(QString const & port);
     void updateTemperature(QString const & temperature);
     void updateConnection(bool connected);
+    void updateLatency(QString const & summary, QString const & details);
+    void updateCommand(QString const & command, bool success);
 
 private:
     QString getStatus();
@@ -24,7 +27,9 @@ private:
     QString m_firmware_version;
     QString m_serial_port;
     QString m_temperature;
+    QString m_command;
     bool m_connection_state;
+    QLabel m_latency;
 };
 
 #endif // STATUSBAR_H
@@ -0,0 +1,77 @@
+#include "timeline.h"
+
+#include <QHBoxLayout>
+
+Timeline::Timeline(QWidget *parent) : QWidget(parent), m_slider(Qt::Horizontal)
+{
+    m_history = nullptr;
+
+    m_pause.setText("Pause");
+    m_pause.setCheckable(true);
+    m_pause.setShortcut(QKeySequence(Qt::Key_Space));
+    m_pause.setToolTip("Pause the display and browse the history (Space)");
+    m_slider.setEnabled(false);
+    m_position.setText("Live");
+    m_position.setMinimumWidth(fontMetrics().horizontalAdvance("Frame 0000000000  |  -0000.00 s"));
+
+    auto layout = new QHBoxLayout(this);
+    layout->addWidget(&m_pause);
+    layout->addWidget(&m_slider, 1);
+    layout->addWidget(&m_position);
+
+    QObject::connect(&m_pause, &QPushButton::toggled, this, &Timeline::pause);
+    QObject::connect(&m_slider, &QSlider::valueChanged, this, &Timeline::select);
+
+    setVisible(false);
+}
+
+void Timeline::setHistory(HistoryRing *history)
+{
+    m_history = history;
+}
+
+void Timeline::pause(bool paused)
+{
+    if (m_history == nullptr)
+        return;
+
+    m_history->setFrozen(paused);
+
+    if (!paused)
+    {
+        m_slider.setEnabled(false);
+        m_pause.setText("Pause");
+        m_position.setText("Live");
+        emit pausedChanged(false);
+        return;
+    }
+
+    auto count = static_cast<int>(m_history->frameCount());
+    if (count == 0)
+    {
+        m_history->setFrozen(false);
+        m_pause.setChecked(false);
+        return;
+    }
+
+    m_pause.setText("Live");
+    emit pausedChanged(true);
+
+    // Start at the newest frame, which is the one shown when pausing
+    QSignalBlocker blocker(&m_slider);
+    m_slider.setRange(0, count - 1);
+    m_slider.setValue(count - 1);
+    m_slider.setEnabled(true);
+    m_slider.setFocus();
+    select(count - 1);
+}
+
+void Timeline::select(int index)
+{
+    if (m_history == nullptr || !m_history->isFrozen() || !m_history->frame(index, m_frame))
+        return;
+
+    auto age = (m_history->timestamp(m_history->frameCount() - 1) - m_frame.header.timestamp_ns) / 1e9;
+    m_position.setText(QString("Frame %1  |  %2 s").arg(m_frame.header.frame_number).arg(-age, 0, 'f', 2));
+    emit frameSelected(m_frame);
+}
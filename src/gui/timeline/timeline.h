@@ -0,0 +1,37 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <logic/history/historyring.h>
+
+#include <QLabel>
+#include <QPushButton>
+#include <QSlider>
+#include <QWidget>
+
+// Pauses the live display and browses the frames kept in the history
+class Timeline : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit Timeline(QWidget *parent = nullptr);
+
+    void setHistory(HistoryRing *history);
+
+signals:
+    void pausedChanged(bool paused);
+    void frameSelected(HistoryFrame_t const & frame);
+
+private slots:
+    void pause(bool paused);
+    void select(int index);
+
+private:
+    HistoryRing *m_history;
+    HistoryFrame_t m_frame;
+    QPushButton m_pause;
+    QSlider m_slider;
+    QLabel m_position;
+};
+
+#endif // TIMELINE_H
@@ -0,0 +1,19 @@
+#include "framesource.h"
+
+FrameSource::FrameSource(QObject *parent) : QObject(parent)
+{
+    m_pipeline = nullptr;
+}
+
+FrameSource::~FrameSource()
+{}
+
+void FrameSource::setPipeline(Pipeline *pipeline)
+{
+    m_pipeline = pipeline;
+}
+
+Pipeline *FrameSource::pipeline() const
+{
+    return m_pipeline;
+}
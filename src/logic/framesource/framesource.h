@@ -0,0 +1,32 @@
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <logic/pipeline/pipeline.h>
+
+#include <QObject>
+
+
+class FrameSource : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrameSource(QObject *parent = nullptr);
+    virtual ~FrameSource();
+
+    void setPipeline(Pipeline *pipeline);
+    Pipeline * pipeline() const;
+
+public slots:
+    virtual void run() = 0;
+    virtual void stop() = 0;
+
+signals:
+    void connectionChanged(bool connected);
+    void finished();
+
+private:
+    Pipeline *m_pipeline;
+};
+
+#endif // FRAMESOURCE_H
@@ -0,0 +1,113 @@
+#include "replaysource.h"
+
+#include <misc/constants.h>
+#include <QDebug>
+#include <QThread>
+
+// Constants
+constexpr auto REPLAY_MAX_SLEEP_US = 50000;    // Longest uninterrupted wait, so stop() takes effect quickly
+
+ReplaySource::ReplaySource(QObject *parent) : FrameSource(parent)
+{
+    m_speed = REPLAY_SPEED_REALTIME;
+    m_start_time = 0.0;
+    m_first_timestamp = -1;
+    m_shutdown = false;
+}
+
+ReplaySource::~ReplaySource()
+{}
+
+bool ReplaySource::open(const QString &path)
+{
+    if (!m_reader.open(path))
+        return false;
+
+    qInfo() << "Opened recording:" << path << "(" << m_reader.frameCount() << "frames )";
+    return true;
+}
+
+void ReplaySource::setSpeed(double speed)
+{
+    m_speed = speed;
+}
+
+void ReplaySource::setStartTime(double seconds)
+{
+    m_start_time = seconds;
+}
+
+void ReplaySource::run()
+{
+    RecordedFrameView_t view;
+    Frame_Info_t frame_info;
+    std::vector<float> samples;
+    Targets_t targets;
+    quint64 frames = 0;
+
+    // Seek through the index, so starting in the middle of a large recording is instant
+    size_t index = 0;
+    if (m_start_time > 0 && m_reader.frame(0, view))
+        index = m_reader.findTimestamp(view.frame->timestamp_ns + static_cast<qint64>(m_start_time * 1e9));
+
+    m_first_timestamp = -1;
+    m_clock.start();
+    emit connectionChanged(true);
+
+    for (; !m_shutdown && index < m_reader.frameCount(); index++)
+    {
+        // Frames which are corrupt or don't match the layout expected by the pipeline are skipped
+        if (!m_reader.frame(index, view) || pipeline() == nullptr)
+            continue;
+
+        if (!waitUntilDue(view.frame->timestamp_ns))
+            break;
+
+        m_reader.unpack(view, samples, frame_info);
+        if (samples.size() < 4 * frame_info.num_samples_per_chirp)
+            continue;
+
+        pipeline()->processFrame(frame_info, view.frame->timestamp_ns);
+        frames++;
+
+        if (view.targets != nullptr)
+        {
+            targets.resize(view.num_targets);
+            std::copy(view.targets, view.targets + view.num_targets, targets.begin());
+            pipeline()->processTargets(targets, view.targets_timestamp_ns);
+        }
+    }
+
+    auto elapsed = m_clock.elapsed();
+    qInfo() << "Replay finished:" << frames << "frames in" << elapsed << "ms"
+            << "(" << (elapsed > 0 ? frames * 1000.0 / elapsed : 0.0) << "fps )";
+
+    emit connectionChanged(false);
+    emit finished();
+}
+
+void ReplaySource::stop()
+{
+    m_shutdown = true;
+}
+
+bool ReplaySource::waitUntilDue(qint64 timestamp_ns)
+{
+    if (m_first_timestamp < 0)
+        m_first_timestamp = timestamp_ns;
+
+    if (m_speed <= REPLAY_SPEED_UNTHROTTLED)
+        return !m_shutdown;
+
+    // Gaps in the recording or a slow speed can mean long waits, which are sliced to notice stop()
+    auto due_ns = static_cast<qint64>((timestamp_ns - m_first_timestamp) / m_speed);
+    for (auto ahead_ns = due_ns - m_clock.nsecsElapsed(); ahead_ns > 0; ahead_ns = due_ns - m_clock.nsecsElapsed())
+    {
+        if (m_shutdown)
+            return false;
+
+        QThread::usleep(qMin<qint64>(ahead_ns / 1000, REPLAY_MAX_SLEEP_US));
+    }
+
+    return !m_shutdown;
+}
@@ -0,0 +1,40 @@
+#ifndef REPLAYSOURCE_H
+#define REPLAYSOURCE_H
+
+#include <misc/types.h>
+#include <logic/framesource/framesource.h>
+#include <logic/recording/recordingreader.h>
+
+#include <QElapsedTimer>
+#include <atomic>
+
+
+class ReplaySource : public FrameSource
+{
+    Q_OBJECT
+
+public:
+    explicit ReplaySource(QObject *parent = nullptr);
+    ~ReplaySource();
+
+    bool open(QString const & path);
+    void setSpeed(double speed);
+    void setStartTime(double seconds);
+
+public slots:
+    void run() override;
+    void stop() override;
+
+private:
+    bool waitUntilDue(qint64 timestamp_ns);     // False if stopped meanwhile
+
+private:
+    RecordingReader m_reader;
+    double m_speed;
+    double m_start_time;
+    qint64 m_first_timestamp;
+    QElapsedTimer m_clock;
+    std::atomic<bool> m_shutdown;
+};
+
+#endif // REPLAYSOURCE_H
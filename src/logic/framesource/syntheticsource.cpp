@@ -0,0 +1,136 @@
+#include "syntheticsource.h"
+
+#include <misc/clock.h>
+#include <misc/constants.h>
+#include <QDebug>
+#include <QThread>
+#include <math.h>
+
+// Constants
+constexpr auto SYNTHETIC_ADC_RESOLUTION = 12;
+constexpr auto SYNTHETIC_NOISE_LEVEL = 0.005f;
+constexpr auto SYNTHETIC_BEAT_FREQUENCY_PER_METER = 2 * RADAR_BANDWITH_EFF / (SPEED_OF_LIGHT * RADAR_RAMP_TIME_EFF);
+
+SyntheticSource::SyntheticSource(QObject *parent) : FrameSource(parent), m_noise(0.0f, SYNTHETIC_NOISE_LEVEL)
+{
+    m_interval_ms = SYNTHETIC_FRAME_INTERVAL;
+    m_frame_number = 0;
+    m_shutdown = false;
+    m_samples.resize(4 * SYNTHETIC_SAMPLES_PER_CHIRP);
+
+    m_targets.append({1.5, -20.0, 0.15, 0.5, 8.0});
+    m_targets.append({4.0, 25.0, 0.08, 1.5, 20.0});
+}
+
+SyntheticSource::~SyntheticSource()
+{}
+
+void SyntheticSource::setFrameInterval(int interval_ms)
+{
+    m_interval_ms = interval_ms;
+}
+
+void SyntheticSource::setTargets(const QVector<SyntheticTarget_t> &targets)
+{
+    m_targets = targets;
+}
+
+void SyntheticSource::run()
+{
+    QElapsedTimer clock;
+    clock.start();
+    emit connectionChanged(true);
+
+    while (!m_shutdown)
+    {
+        auto t = clock.nsecsElapsed() * 1e-9;
+        generateFrame(t);
+        generateTargets(t);
+
+        Frame_Info_t frame_info;
+        frame_info.sample_data = m_samples.data();
+        frame_info.frame_number = m_frame_number++;
+        frame_info.num_chirps = 1;
+        frame_info.num_rx_antennas = 2;
+        frame_info.num_samples_per_chirp = SYNTHETIC_SAMPLES_PER_CHIRP;
+        frame_info.rx_mask = 0x03;
+        frame_info.adc_resolution = SYNTHETIC_ADC_RESOLUTION;
+        frame_info.interleaved_rx = 0;
+        frame_info.data_format = EP_RADAR_BASE_RX_DATA_COMPLEX;
+
+        if (pipeline() != nullptr)
+        {
+            auto timestamp = monotonicTimestamp();
+            pipeline()->processFrame(frame_info, timestamp);
+            pipeline()->processTargets(m_target_infos, timestamp);
+        }
+
+        if (m_interval_ms > 0)
+            QThread::msleep(m_interval_ms);
+    }
+
+    emit connectionChanged(false);
+    emit finished();
+}
+
+void SyntheticSource::stop()
+{
+    m_shutdown = true;
+}
+
+void SyntheticSource::generateFrame(double t)
+{
+    constexpr auto n = SYNTHETIC_SAMPLES_PER_CHIRP;
+    constexpr auto max_code = (1 << SYNTHETIC_ADC_RESOLUTION) - 1;
+
+    for (auto i = 0; i < n; i++)
+    {
+        double re_rx1 = 0.5, im_rx1 = 0.5, re_rx2 = 0.5, im_rx2 = 0.5;
+
+        for (auto const & target : m_targets)
+        {
+            auto radius = target.radius_m + target.sway_m * sin(2 * M_PI * t / target.sway_period_s);
+            auto phase = 2 * M_PI * radius * SYNTHETIC_BEAT_FREQUENCY_PER_METER * i / RADAR_SAMPLING_FREQUENCY;
+            // Half wavelength antenna spacing
+            auto phase_rx2 = phase + M_PI * sin(target.azimuth_deg * M_PI / 180);
+
+            re_rx1 += target.amplitude * cos(phase);
+            im_rx1 += target.amplitude * sin(phase);
+            re_rx2 += target.amplitude * cos(phase_rx2);
+            im_rx2 += target.amplitude * sin(phase_rx2);
+        }
+
+        // Quantize like the sensor does, so replaying and recording behave the same as with hardware
+        auto quantize = [&](double v)
+        {
+            v = qBound(0.0, v + m_noise(m_rng), 1.0);
+            return static_cast<float>(qRound(v * max_code)) / max_code;
+        };
+
+        m_samples[i] = quantize(re_rx1);
+        m_samples[n + i] = quantize(im_rx1);
+        m_samples[2 * n + i] = quantize(re_rx2);
+        m_samples[3 * n + i] = quantize(im_rx2);
+    }
+}
+
+void SyntheticSource::generateTargets(double t)
+{
+    m_target_infos.resize(m_targets.size());
+
+    for (auto i = 0; i < m_targets.size(); i++)
+    {
+        auto const & target = m_targets[i];
+        auto w = 2 * M_PI / target.sway_period_s;
+
+        Target_Info_t & info = m_target_infos[i];
+        info.target_id = i + 1;
+        info.level = 20 * log10(target.amplitude / SYNTHETIC_NOISE_LEVEL);
+        info.radius = (target.radius_m + target.sway_m * sin(w * t)) * 100;
+        info.azimuth = target.azimuth_deg;
+        info.elevation = 0;
+        info.radial_speed = target.sway_m * w * cos(w * t);
+        info.azimuth_speed = 0;
+        info.elevation_speed = 0;
+    }
+}
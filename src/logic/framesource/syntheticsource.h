@@ -0,0 +1,52 @@
+#ifndef SYNTHETICSOURCE_H
+#define SYNTHETICSOURCE_H
+
+#include <misc/types.h>
+#include <logic/framesource/framesource.h>
+
+#include <EndpointRadarBase.h>
+#include <QElapsedTimer>
+#include <atomic>
+#include <random>
+#include <vector>
+
+struct SyntheticTarget_t
+{
+    double radius_m;
+    double azimuth_deg;
+    double amplitude;
+    double sway_m;
+    double sway_period_s;
+};
+
+class SyntheticSource : public FrameSource
+{
+    Q_OBJECT
+
+public:
+    explicit SyntheticSource(QObject *parent = nullptr);
+    ~SyntheticSource();
+
+    void setFrameInterval(int interval_ms);
+    void setTargets(QVector<SyntheticTarget_t> const & targets);
+
+public slots:
+    void run() override;
+    void stop() override;
+
+private:
+    void generateFrame(double t);
+    void generateTargets(double t);
+
+private:
+    int m_interval_ms;
+    uint32_t m_frame_number;
+    QVector<SyntheticTarget_t> m_targets;
+    std::vector<float> m_samples;
+    Targets_t m_target_infos;
+    std::mt19937 m_rng;
+    std::normal_distribution<float> m_noise;
+    std::atomic<bool> m_shutdown;
+};
+
+#endif // SYNTHETICSOURCE_H
@@ -0,0 +1,40 @@
+#include "historyplayer.h"
+
+#include <logic/metrics/tracerecorder.h>
+#include <logic/pipeline/pipeline.h>
+
+HistoryPlayer::HistoryPlayer(QObject *parent) : QObject(parent)
+{}
+
+void HistoryPlayer::setSignalProcessorSettings(const SignalProcessorSettings_t &settings)
+{
+    m_signal_processor.setSettings(settings);
+}
+
+void HistoryPlayer::showFrame(const HistoryFrame_t &frame)
+{
+    TraceScope trace("HistoryPlayer::showFrame");
+
+    Frame_Info_t frame_info;
+    frame_info.sample_data = frame.samples.data();
+    frame_info.frame_number = frame.header.frame_number;
+    frame_info.num_chirps = frame.header.num_chirps;
+    frame_info.num_rx_antennas = frame.header.num_rx_antennas;
+    frame_info.num_samples_per_chirp = frame.header.num_samples_per_chirp;
+    frame_info.rx_mask = frame.header.rx_mask;
+    frame_info.adc_resolution = frame.header.adc_resolution;
+    frame_info.interleaved_rx = frame.header.interleaved_rx;
+    frame_info.data_format = static_cast<Rx_Data_Format_t>(frame.header.data_format);
+
+    DataPoints_t re_rx1, im_rx1, re_rx2, im_rx2;
+    Pipeline::splitSamples(frame_info, re_rx1, im_rx1, re_rx2, im_rx2);
+    emit timeDataChanged(re_rx1, im_rx1, re_rx2, im_rx2);
+
+    auto maximum = 0.0;
+    auto rx1 = m_signal_processor.calculateRangeData(re_rx1, im_rx1);
+    auto rx2 = m_signal_processor.calculateRangeData(re_rx2, im_rx2);
+    auto maxima = m_signal_processor.calculateMaxima(rx1, maximum);
+    emit rangeDataChanged(rx1, rx2, maxima, maximum);
+
+    emit targetDataChanged(frame.targets);
+}
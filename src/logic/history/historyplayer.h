@@ -0,0 +1,33 @@
+#ifndef HISTORYPLAYER_H
+#define HISTORYPLAYER_H
+
+#include <misc/types.h>
+#include <logic/history/historyring.h>
+#include <logic/signalprocessor/signalprocessor.h>
+
+#include <QObject>
+
+// Reprocesses frames from the history on the gui thread with its own signal processor,
+// emitting the same results as the pipeline does for live frames
+class HistoryPlayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HistoryPlayer(QObject *parent = nullptr);
+
+    void setSignalProcessorSettings(SignalProcessorSettings_t const & settings);
+
+public slots:
+    void showFrame(HistoryFrame_t const & frame);
+
+signals:
+    void timeDataChanged(DataPoints_t const & re_rx1, DataPoints_t const & im_rx1, DataPoints_t const & re_rx2, DataPoints_t const & im_rx2);
+    void rangeDataChanged(DataPoints_t const & rx1, DataPoints_t const & rx2, DataPoints_t const & maxima, double const & max_y);
+    void targetDataChanged(Targets_t const & data);
+
+private:
+    SignalProcessor m_signal_processor;
+};
+
+#endif // HISTORYPLAYER_H
@@ -0,0 +1,203 @@
+#include "historyring.h"
+
+#include <logic/metrics/tracerecorder.h>
+
+#include <QDebug>
+#include <cstring>
+
+// Follows the packed ADC codes of a frame record
+struct HistoryMaxima_t
+{
+    uint32_t num_maxima;    // Followed by num_maxima pairs of range and magnitude
+    float maximum;
+};
+
+HistoryRing::HistoryRing()
+{
+    m_head = 0;
+    m_frozen = false;
+}
+
+bool HistoryRing::open(const HistorySettings_t &settings)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_entries.clear();
+    m_head = 0;
+    m_buffer.assign(alignChunkSize(settings.memory), 0);
+    m_buffer.shrink_to_fit();
+
+    if (m_buffer.empty())
+        return false;
+
+    qInfo() << "Keeping" << m_buffer.size() / 1048576.0 << "MB of frame history.";
+    return true;
+}
+
+bool HistoryRing::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_buffer.empty();
+}
+
+void HistoryRing::setFrozen(bool frozen)
+{
+    // Waits for a write in progress, so the ring doesn't change anymore once frozen
+    QMutexLocker locker(&m_mutex);
+    m_frozen = frozen;
+}
+
+bool HistoryRing::isFrozen() const
+{
+    return m_frozen;
+}
+
+void HistoryRing::writeFrame(const Frame_Info_t &frame_info, const DataPoints_t &maxima, double maximum, qint64 timestamp_ns)
+{
+    if (m_frozen)
+        return;
+
+    TraceScope trace("HistoryRing::writeFrame");
+
+    auto num_samples = totalSampleCount(frame_info);
+    auto packed_size = alignChunkSize(packedSampleSize(num_samples, frame_info.adc_resolution));
+    auto size = sizeof(FrameChunk_t) + packed_size + sizeof(HistoryMaxima_t) + alignChunkSize(maxima.size() * 2 * sizeof(float));
+
+    QMutexLocker locker(&m_mutex);
+
+    // Frozen while the frame was prepared, the browsed frames must not change anymore
+    if (m_frozen)
+        return;
+
+    size_t offset;
+    auto record = allocate(size, offset);
+    if (record == nullptr)
+        return;
+
+    FrameChunk_t chunk;
+    chunk.timestamp_ns = timestamp_ns;
+    chunk.frame_number = frame_info.frame_number;
+    chunk.num_chirps = frame_info.num_chirps;
+    chunk.num_samples_per_chirp = frame_info.num_samples_per_chirp;
+    chunk.num_rx_antennas = frame_info.num_rx_antennas;
+    chunk.rx_mask = frame_info.rx_mask;
+    chunk.adc_resolution = frame_info.adc_resolution;
+    chunk.interleaved_rx = frame_info.interleaved_rx;
+    chunk.data_format = frame_info.data_format;
+    memset(chunk.reserved, 0, sizeof(chunk.reserved));
+    chunk.num_samples = num_samples;
+    memcpy(record, &chunk, sizeof(chunk));
+    packAdcSamples(frame_info.sample_data, num_samples, frame_info.adc_resolution, record + sizeof(chunk));
+
+    HistoryMaxima_t header;
+    header.num_maxima = maxima.size();
+    header.maximum = maximum;
+    auto p = record + sizeof(chunk) + packed_size;
+    memcpy(p, &header, sizeof(header));
+
+    auto values = reinterpret_cast<float*>(p + sizeof(header));
+    for (auto const & point : maxima)
+    {
+        *values++ = point.x();
+        *values++ = point.y();
+    }
+
+    m_entries.push_back({offset, size, 0, 0, timestamp_ns, frame_info.frame_number});
+}
+
+void HistoryRing::writeTargets(const Targets_t &targets)
+{
+    if (m_frozen || targets.isEmpty())
+        return;
+
+    auto size = targets.size() * sizeof(Target_Info_t);
+
+    QMutexLocker locker(&m_mutex);
+
+    if (m_frozen)
+        return;
+
+    size_t offset;
+    auto record = allocate(size, offset);
+    if (record == nullptr || m_entries.empty())
+        return;
+
+    memcpy(record, targets.constData(), size);
+    m_entries.back().targets_offset = offset;
+    m_entries.back().targets_size = size;
+}
+
+size_t HistoryRing::frameCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+qint64 HistoryRing::timestamp(size_t index) const
+{
+    QMutexLocker locker(&m_mutex);
+    return index < m_entries.size() ? m_entries[index].timestamp_ns : 0;
+}
+
+bool HistoryRing::frame(size_t index, HistoryFrame_t &frame) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (index >= m_entries.size())
+        return false;
+
+    auto const & entry = m_entries[index];
+    auto record = m_buffer.data() + entry.offset;
+    memcpy(&frame.header, record, sizeof(frame.header));
+
+    frame.samples.resize(frame.header.num_samples);
+    unpackAdcSamples(record + sizeof(frame.header), frame.header.num_samples, frame.header.adc_resolution, frame.samples.data());
+
+    HistoryMaxima_t header;
+    auto p = record + sizeof(frame.header) + alignChunkSize(packedSampleSize(frame.header.num_samples, frame.header.adc_resolution));
+    memcpy(&header, p, sizeof(header));
+
+    frame.maximum = header.maximum;
+    frame.maxima.clear();
+    auto values = reinterpret_cast<const float*>(p + sizeof(header));
+    for (uint32_t i = 0; i < header.num_maxima; i++)
+        frame.maxima.append(QPointF(values[2 * i], values[2 * i + 1]));
+
+    frame.targets.resize(entry.targets_size / sizeof(Target_Info_t));
+    if (entry.targets_size > 0)
+        memcpy(frame.targets.data(), m_buffer.data() + entry.targets_offset, entry.targets_size);
+
+    return true;
+}
+
+uint8_t *HistoryRing::allocate(size_t size, size_t &offset)
+{
+    size = alignChunkSize(size);
+    if (size > m_buffer.size())
+        return nullptr;
+
+    // A record never wraps, the remainder at the end of the buffer stays unused then
+    auto wrapped = m_head + size > m_buffer.size();
+    offset = wrapped ? 0 : m_head;
+
+    // The oldest records follow the write position, drop all which would be overwritten
+    while (!m_entries.empty())
+    {
+        auto const & oldest = m_entries.front();
+        auto skipped = wrapped && oldest.offset >= m_head;
+        if (!skipped &&
+            !overlaps(offset, size, oldest.offset, oldest.offset + oldest.size) &&
+            !overlaps(offset, size, oldest.targets_offset, oldest.targets_offset + oldest.targets_size))
+            break;
+
+        m_entries.pop_front();
+    }
+
+    m_head = offset + size;
+    return m_buffer.data() + offset;
+}
+
+bool HistoryRing::overlaps(size_t offset, size_t size, size_t begin, size_t end)
+{
+    return begin < end && offset < end && begin < offset + size;
+}
@@ -0,0 +1,71 @@
+#ifndef HISTORYRING_H
+#define HISTORYRING_H
+
+#include <misc/types.h>
+#include <logic/recording/recordingformat.h>
+
+#include <QMutex>
+#include <atomic>
+#include <deque>
+#include <vector>
+
+struct HistorySettings_t
+{
+    quint64 memory;             // Bytes, 0 disables the history
+};
+
+struct HistoryFrame_t
+{
+    FrameChunk_t header;
+    std::vector<float> samples;
+    DataPoints_t maxima;
+    double maximum;
+    Targets_t targets;          // Targets received after the frame
+};
+
+struct HistoryEntry_t
+{
+    size_t offset;
+    size_t size;
+    size_t targets_offset;
+    size_t targets_size;
+    qint64 timestamp_ns;
+    uint32_t frame_number;
+};
+
+// Keeps the latest frames within a fixed memory budget: ADC codes are stored packed as in recordings,
+// together with the range maxima and the targets of each frame. Records are written one after another
+// into a preallocated buffer and the oldest frames are dropped as the writer wraps around.
+// Written by the acquisition thread, read by the gui thread.
+class HistoryRing
+{
+public:
+    HistoryRing();
+
+    bool open(HistorySettings_t const & settings);
+    bool isOpen() const;
+
+    // While frozen, new frames are not stored, so the kept ones can be browsed
+    void setFrozen(bool frozen);
+    bool isFrozen() const;
+
+    void writeFrame(Frame_Info_t const & frame_info, DataPoints_t const & maxima, double maximum, qint64 timestamp_ns);
+    void writeTargets(Targets_t const & targets);
+
+    size_t frameCount() const;
+    qint64 timestamp(size_t index) const;
+    bool frame(size_t index, HistoryFrame_t & frame) const;
+
+private:
+    uint8_t * allocate(size_t size, size_t & offset);
+    static bool overlaps(size_t offset, size_t size, size_t begin, size_t end);
+
+private:
+    mutable QMutex m_mutex;
+    std::vector<uint8_t> m_buffer;
+    std::deque<HistoryEntry_t> m_entries;
+    size_t m_head;
+    std::atomic<bool> m_frozen;
+};
+
+#endif // HISTORYRING_H
@@ -0,0 +1,227 @@
+#include "latencymetrics.h"
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void LatencyHistogram::record(qint64 value_ns)
+{
+    if (value_ns < 0)
+        value_ns = 0;
+
+    m_buckets[bucketIndex(static_cast<quint64>(value_ns))].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value_ns, std::memory_order_relaxed);
+
+    auto max = m_max.load(std::memory_order_relaxed);
+    while (value_ns > max && !m_max.compare_exchange_weak(max, value_ns, std::memory_order_relaxed))
+    {}
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto & bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+qint64 LatencyHistogram::sum() const
+{
+    return m_sum.load(std::memory_order_relaxed);
+}
+
+qint64 LatencyHistogram::max() const
+{
+    return m_max.load(std::memory_order_relaxed);
+}
+
+qint64 LatencyHistogram::percentile(double p) const
+{
+    // Sum up the buckets instead of using m_count, which may be ahead of them while recording
+    Counts_t counts;
+    this->counts(counts);
+
+    Counts_t none{};
+    auto value = percentile(counts, none, p);
+    return qMin(value, max());
+}
+
+void LatencyHistogram::counts(Counts_t &counts) const
+{
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+}
+
+qint64 LatencyHistogram::percentile(const Counts_t &counts, const Counts_t &previous, double p)
+{
+    // After a reset within the interval, only the counts since the reset are left
+    Counts_t interval;
+    quint64 total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        interval[i] = counts[i] >= previous[i] ? counts[i] - previous[i] : counts[i];
+        total += interval[i];
+    }
+
+    if (total == 0)
+        return 0;
+
+    auto rank = static_cast<quint64>(p / 100.0 * total + 0.5);
+    if (rank < 1)
+        rank = 1;
+
+    quint64 seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        seen += interval[i];
+        if (seen >= rank)
+            return static_cast<qint64>(bucketUpperBound(i));
+    }
+
+    return static_cast<qint64>(bucketUpperBound(BUCKET_COUNT - 1));
+}
+
+size_t LatencyHistogram::bucketIndex(quint64 value)
+{
+    if (value < SUB_BUCKET_COUNT)
+        return value;
+
+    // Position of the highest set bit selects the power of two, the next bits the sub bucket
+    size_t msb = 63;
+    while (!(value >> msb))
+        msb--;
+
+    auto shift = msb - SUB_BUCKET_BITS;
+    return SUB_BUCKET_COUNT + shift * SUB_BUCKET_COUNT + ((value >> shift) - SUB_BUCKET_COUNT);
+}
+
+quint64 LatencyHistogram::bucketUpperBound(size_t index)
+{
+    if (index < SUB_BUCKET_COUNT)
+        return index;
+
+    auto shift = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT;
+    auto sub_bucket = (index - SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+LatencyMetrics::LatencyMetrics()
+{
+    m_enabled = false;
+    m_end_to_end_enabled = true;
+}
+
+LatencyMetrics & LatencyMetrics::instance()
+{
+    static LatencyMetrics metrics;
+    return metrics;
+}
+
+void LatencyMetrics::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void LatencyMetrics::setEndToEndEnabled(bool enabled)
+{
+    m_end_to_end_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void LatencyMetrics::record(LatencyStage_t stage, qint64 duration_ns)
+{
+    if (!isEnabled())
+        return;
+
+    m_histograms[static_cast<size_t>(stage)].record(duration_ns);
+}
+
+void LatencyMetrics::reset()
+{
+    for (auto & histogram : m_histograms)
+        histogram.reset();
+}
+
+const LatencyHistogram &LatencyMetrics::histogram(LatencyStage_t stage) const
+{
+    return m_histograms[static_cast<size_t>(stage)];
+}
+
+QString LatencyMetrics::summary() const
+{
+    QString msg = "Latency p50/p99/max [us]: ";
+    auto first = true;
+
+    for (size_t i = 0; i < m_histograms.size(); i++)
+    {
+        auto stage = static_cast<LatencyStage_t>(i);
+        auto const & h = m_histograms[i];
+        if (h.count() == 0)
+            continue;
+
+        if (!first)
+            msg.append("  |  ");
+        first = false;
+
+        msg.append(QString("%1 %2/%3/%4")
+                    .arg(stageName(stage))
+                    .arg(h.percentile(50) / 1e3, 0, 'f', 0)
+                    .arg(h.percentile(99) / 1e3, 0, 'f', 0)
+                    .arg(h.max() / 1e3, 0, 'f', 0));
+    }
+
+    return msg;
+}
+
+QString LatencyMetrics::dump() const
+{
+    QString msg = QString("%1 %2 %3 %4 %5 %6\n")
+                    .arg("Stage", -16)
+                    .arg("Count", 10)
+                    .arg("p50 [us]", 12)
+                    .arg("p90 [us]", 12)
+                    .arg("p99 [us]", 12)
+                    .arg("Max [us]", 12);
+
+    for (size_t i = 0; i < m_histograms.size(); i++)
+    {
+        auto stage = static_cast<LatencyStage_t>(i);
+        auto const & h = m_histograms[i];
+
+        msg.append(QString("%1 %2 %3 %4 %5 %6\n")
+                    .arg(stageName(stage), -16)
+                    .arg(h.count(), 10)
+                    .arg(h.percentile(50) / 1e3, 12, 'f', 1)
+                    .arg(h.percentile(90) / 1e3, 12, 'f', 1)
+                    .arg(h.percentile(99) / 1e3, 12, 'f', 1)
+                    .arg(h.max() / 1e3, 12, 'f', 1));
+    }
+
+    return msg;
+}
+
+QString LatencyMetrics::stageName(LatencyStage_t stage)
+{
+    switch (stage)
+    {
+        case LatencyStage_t::SerialRead: return "Serial read";
+        case LatencyStage_t::PayloadParse: return "Payload parse";
+        case LatencyStage_t::FrameCallback: return "Frame callback";
+        case LatencyStage_t::Fft: return "FFT";
+        case LatencyStage_t::Persistence: return "Persistence";
+        case LatencyStage_t::Emit: return "Emit";
+        case LatencyStage_t::ChartUpdate: return "Chart update";
+        case LatencyStage_t::EndToEnd: return "End-to-end";
+        case LatencyStage_t::Count: break;
+    }
+
+    return "Unknown";
+}
@@ -0,0 +1,113 @@
+#ifndef LATENCYMETRICS_H
+#define LATENCYMETRICS_H
+
+#include <misc/clock.h>
+
+#include <QString>
+#include <array>
+#include <atomic>
+
+enum class LatencyStage_t
+{
+    SerialRead,     // Reception of the frame message from the serial port
+    PayloadParse,   // Parsing of the frame message up to the frame callback
+    FrameCallback,  // Recording, publishing and conversion of the frame
+    Fft,            // Range data of both antennas
+    Persistence,    // Maxima of the range data
+    Emit,           // Publishing and emitting the range data
+    ChartUpdate,    // Updating the series of a chart
+    EndToEnd,       // Frame callback until the range chart is updated
+    Count
+};
+
+// Histogram of durations in nanoseconds with a relative error below 1/16: values are grouped by their power
+// of two, each power of two is split into 16 linear sub buckets. Recording only takes relaxed atomic updates
+// of the bucket, count, sum and max, so any thread can record while another one reads.
+class LatencyHistogram
+{
+private:
+    static constexpr size_t SUB_BUCKET_BITS = 4;
+    static constexpr size_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT;
+
+public:
+    using Counts_t = std::array<quint64, BUCKET_COUNT>;
+
+    LatencyHistogram();
+
+    void record(qint64 value_ns);
+    void reset();
+
+    quint64 count() const;
+    qint64 sum() const;
+    qint64 max() const;
+    qint64 percentile(double p) const;
+
+    // Percentiles of an interval, from the bucket counts at its begin and end
+    void counts(Counts_t & counts) const;
+    static qint64 percentile(Counts_t const & counts, Counts_t const & previous, double p);
+
+private:
+    static size_t bucketIndex(quint64 value);
+    static quint64 bucketUpperBound(size_t index);
+
+private:
+    std::array<std::atomic<quint64>, BUCKET_COUNT> m_buckets;
+    std::atomic<quint64> m_count;
+    std::atomic<qint64> m_sum;
+    std::atomic<qint64> m_max;
+};
+
+// Latency histograms of all stages from the serial port to the charts, disabled by default
+class LatencyMetrics
+{
+public:
+    static LatencyMetrics & instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Replays carry the recorded acquisition timestamps, which can't be compared to the current time
+    void setEndToEndEnabled(bool enabled);
+    bool isEndToEndEnabled() const { return isEnabled() && m_end_to_end_enabled.load(std::memory_order_relaxed); }
+
+    void record(LatencyStage_t stage, qint64 duration_ns);
+    void reset();
+
+    LatencyHistogram const & histogram(LatencyStage_t stage) const;
+    QString summary() const;
+    QString dump() const;
+
+    static QString stageName(LatencyStage_t stage);
+
+private:
+    LatencyMetrics();
+
+private:
+    std::atomic<bool> m_enabled;
+    std::atomic<bool> m_end_to_end_enabled;
+    std::array<LatencyHistogram, static_cast<size_t>(LatencyStage_t::Count)> m_histograms;
+};
+
+// Records the lifetime of the scope into the histogram of a stage
+class LatencyScope
+{
+public:
+    explicit LatencyScope(LatencyStage_t stage)
+        : m_stage(stage), m_begin(LatencyMetrics::instance().isEnabled() ? monotonicTimestamp() : 0) {}
+
+    ~LatencyScope()
+    {
+        if (m_begin != 0)
+            LatencyMetrics::instance().record(m_stage, monotonicTimestamp() - m_begin);
+    }
+
+    LatencyScope(LatencyScope const &) = delete;
+    LatencyScope & operator=(LatencyScope const &) = delete;
+
+private:
+    LatencyStage_t m_stage;
+    qint64 m_begin;
+};
+
+#endif // LATENCYMETRICS_H
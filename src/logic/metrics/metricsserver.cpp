@@ -0,0 +1,215 @@
+#include "metricsserver.h"
+
+#include <logic/metrics/latencymetrics.h>
+#include <logic/recording/recordingwriter.h>
+#include <logic/streaming/streamserver.h>
+
+#include <QDebug>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+// Constants
+constexpr auto METRICS_RATE_INTERVAL = 1000;
+constexpr auto METRICS_MAX_REQUEST_SIZE = 8192;
+constexpr double METRICS_QUANTILES[] = {0.5, 0.9, 0.99};
+
+static void appendMetric(QByteArray & out, char const * name, char const * type, char const * help, double value)
+{
+    out.append(QString("# HELP %1 %2\n# TYPE %1 %3\n%1 %4\n").arg(name).arg(help).arg(type).arg(value, 0, 'g', 15).toUtf8());
+}
+
+MetricsServer::MetricsServer(QObject *parent) : QObject(parent)
+{
+    m_server = nullptr;
+    m_recorder = nullptr;
+    m_stream_server = nullptr;
+    m_rate_snapshot = Telemetry::instance().snapshot();
+    m_serial_bytes_per_second = 0.0;
+    m_gui_frames_per_second = 0.0;
+
+    QObject::connect(&m_rate_timer, &QTimer::timeout, this, &MetricsServer::updateRates);
+}
+
+MetricsServer::~MetricsServer()
+{
+    close();
+}
+
+bool MetricsServer::open(const MetricsSettings_t &settings)
+{
+    QHostAddress address(settings.address);
+    if (address.isNull())
+    {
+        qWarning() << "Invalid metrics address:" << settings.address;
+        return false;
+    }
+
+    m_server = new QTcpServer(this);
+    QObject::connect(m_server, &QTcpServer::newConnection, this, &MetricsServer::acceptConnection);
+
+    if (!m_server->listen(address, settings.port))
+    {
+        qWarning() << "Error while listening for metrics requests:" << m_server->errorString();
+        close();
+        return false;
+    }
+
+    m_rate_snapshot = Telemetry::instance().snapshot();
+    m_rate_elapsed.start();
+    m_rate_timer.start(METRICS_RATE_INTERVAL);
+
+    qInfo() << "Serving metrics on" << settings.address << "port" << m_server->serverPort();
+    return true;
+}
+
+void MetricsServer::close()
+{
+    m_rate_timer.stop();
+
+    for (auto it = m_requests.begin(); it != m_requests.end(); it++)
+    {
+        it.key()->disconnect(this);
+        delete it.key();
+    }
+    m_requests.clear();
+
+    delete m_server;
+    m_server = nullptr;
+}
+
+void MetricsServer::setRecorder(const RecordingWriter *recorder)
+{
+    m_recorder = recorder;
+}
+
+void MetricsServer::setStreamServer(const StreamServer *server)
+{
+    m_stream_server = server;
+}
+
+void MetricsServer::acceptConnection()
+{
+    while (m_server->hasPendingConnections())
+    {
+        auto socket = m_server->nextPendingConnection();
+        m_requests.insert(socket, QByteArray());
+
+        QObject::connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { readRequest(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_requests.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void MetricsServer::updateRates()
+{
+    auto snapshot = Telemetry::instance().snapshot();
+    auto seconds = m_rate_elapsed.restart() / 1000.0;
+
+    if (seconds > 0.0)
+    {
+        m_serial_bytes_per_second = (snapshot.serial_received_bytes - m_rate_snapshot.serial_received_bytes) / seconds;
+        m_gui_frames_per_second = (snapshot.gui_frames - m_rate_snapshot.gui_frames) / seconds;
+    }
+
+    m_rate_snapshot = snapshot;
+}
+
+void MetricsServer::readRequest(QTcpSocket *socket)
+{
+    if (!m_requests.contains(socket))
+        return;
+
+    auto & request = m_requests[socket];
+    request.append(socket->readAll());
+
+    // Only the request line matters, the headers are read until their end and ignored
+    if (!request.contains("\r\n\r\n"))
+    {
+        if (request.size() > METRICS_MAX_REQUEST_SIZE)
+            respond(socket, "431 Request Header Fields Too Large", QByteArray());
+        return;
+    }
+
+    auto line = request.left(request.indexOf("\r\n")).split(' ');
+    if (line.size() < 2 || (line[0] != "GET" && line[0] != "HEAD"))
+        respond(socket, "405 Method Not Allowed", QByteArray());
+    else if (line[1] != "/metrics")
+        respond(socket, "404 Not Found", QByteArray());
+    else
+        respond(socket, "200 OK", line[0] == "HEAD" ? QByteArray() : metrics());
+}
+
+void MetricsServer::respond(QTcpSocket *socket, const QByteArray &status, const QByteArray &body)
+{
+    QByteArray response = "HTTP/1.1 " + status + "\r\n"
+                          "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n\r\n" + body;
+
+    m_requests.remove(socket);
+    socket->disconnect(this);
+    QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+QByteArray MetricsServer::metrics() const
+{
+    QByteArray out;
+    auto t = Telemetry::instance().snapshot();
+
+    appendMetric(out, "p2g_frames_received_total", "counter", "Frames received from the frame source.", t.frames_received);
+    appendMetric(out, "p2g_frames_processed_total", "counter", "Frames of which the range data was calculated.", t.frames_processed);
+    appendMetric(out, "p2g_frame_gaps_total", "counter", "Discontinuities of the frame number.", t.frame_gaps);
+    appendMetric(out, "p2g_frames_missed_total", "counter", "Frame numbers skipped by discontinuities.", t.frames_missed);
+    appendMetric(out, "p2g_serial_received_bytes_total", "counter", "Bytes received from the serial port.", t.serial_received_bytes);
+    appendMetric(out, "p2g_serial_received_bytes_per_second", "gauge", "Bytes received from the serial port per second.", m_serial_bytes_per_second);
+    appendMetric(out, "p2g_serial_resyncs_total", "counter", "Received data discarded to get in sync with the message stream.", t.serial_resyncs);
+    appendMetric(out, "p2g_gui_frames_total", "counter", "Range chart updates.", t.gui_frames);
+    appendMetric(out, "p2g_gui_frames_per_second", "gauge", "Range chart updates per second.", m_gui_frames_per_second);
+    appendMetric(out, "p2g_gui_frames_skipped_total", "counter", "Range data replaced by newer data before it was shown.", t.gui_frames_skipped);
+
+    if (t.temperature_valid)
+        appendMetric(out, "p2g_temperature_celsius", "gauge", "Temperature of the radar sensor.", t.temperature);
+
+    if (m_recorder != nullptr && m_recorder->isOpen())
+    {
+        auto r = m_recorder->statistics();
+        appendMetric(out, "p2g_recording_frames_written_total", "counter", "Frames written into the recording.", r.frames_written);
+        appendMetric(out, "p2g_recording_frames_dropped_total", "counter", "Frames dropped from the recording as the queue was full.", r.frames_dropped);
+        appendMetric(out, "p2g_recording_queue_depth", "gauge", "Chunks queued for the recording writer.", r.queue_depth);
+    }
+
+    if (m_stream_server != nullptr)
+    {
+        auto s = m_stream_server->statistics();
+        appendMetric(out, "p2g_stream_clients", "gauge", "Connected stream clients.", s.clients);
+        appendMetric(out, "p2g_stream_messages_dropped_total", "counter", "Messages dropped for slow stream clients.", s.messages_dropped);
+        appendMetric(out, "p2g_stream_pending_bytes", "gauge", "Bytes queued for stream clients.", s.pending_bytes);
+    }
+
+    auto & latency = LatencyMetrics::instance();
+    if (latency.isEnabled())
+    {
+        out.append("# HELP p2g_stage_latency_seconds Duration of the processing stages.\n"
+                   "# TYPE p2g_stage_latency_seconds summary\n");
+
+        for (auto i = 0; i < static_cast<int>(LatencyStage_t::Count); i++)
+        {
+            auto stage = static_cast<LatencyStage_t>(i);
+            auto const & h = latency.histogram(stage);
+            auto label = LatencyMetrics::stageName(stage).toLower().replace(' ', '_').replace('-', '_');
+
+            for (auto q : METRICS_QUANTILES)
+                out.append(QString("p2g_stage_latency_seconds{stage=\"%1\",quantile=\"%2\"} %3\n").arg(label).arg(q).arg(h.percentile(q * 100.0) / 1e9, 0, 'g', 9).toUtf8());
+
+            out.append(QString("p2g_stage_latency_seconds_sum{stage=\"%1\"} %2\n").arg(label).arg(h.sum() / 1e9, 0, 'g', 15).toUtf8());
+            out.append(QString("p2g_stage_latency_seconds_count{stage=\"%1\"} %2\n").arg(label).arg(h.count()).toUtf8());
+        }
+    }
+
+    return out;
+}
@@ -0,0 +1,62 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <logic/metrics/telemetry.h>
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+
+class QTcpServer;
+class QTcpSocket;
+class RecordingWriter;
+class StreamServer;
+
+struct MetricsSettings_t
+{
+    QString address;    // Address to listen on, the loopback interface by default
+    quint16 port;
+};
+
+// Serves counters and gauges in the Prometheus text format on GET /metrics. Requests are tiny and
+// rare, so the server runs in the thread that opens it.
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+    ~MetricsServer();
+
+    bool open(MetricsSettings_t const & settings);
+    void close();
+
+    void setRecorder(RecordingWriter const *recorder);
+    void setStreamServer(StreamServer const *server);
+
+private slots:
+    void acceptConnection();
+    void updateRates();
+
+private:
+    void readRequest(QTcpSocket *socket);
+    void respond(QTcpSocket *socket, QByteArray const & status, QByteArray const & body);
+    QByteArray metrics() const;
+
+private:
+    QTcpServer *m_server;
+    QHash<QTcpSocket*, QByteArray> m_requests;
+    RecordingWriter const *m_recorder;
+    StreamServer const *m_stream_server;
+
+    // Rates between two ticks of the timer
+    QTimer m_rate_timer;
+    QElapsedTimer m_rate_elapsed;
+    TelemetrySnapshot_t m_rate_snapshot;
+    double m_serial_bytes_per_second;
+    double m_gui_frames_per_second;
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,79 @@
+#include "telemetry.h"
+
+Telemetry::Telemetry()
+{
+    m_frames_received = 0;
+    m_frame_gaps = 0;
+    m_frames_missed = 0;
+    m_frames_processed = 0;
+    m_serial_received_bytes = 0;
+    m_serial_resyncs = 0;
+    m_gui_frames = 0;
+    m_gui_frames_skipped = 0;
+    m_temperature_valid = false;
+    m_temperature = 0;
+    m_last_frame_number = 0;
+}
+
+Telemetry & Telemetry::instance()
+{
+    static Telemetry telemetry;
+    return telemetry;
+}
+
+void Telemetry::frameReceived(quint32 frame_number)
+{
+    if (m_frames_received.fetch_add(1, std::memory_order_relaxed) > 0 && frame_number != m_last_frame_number + 1)
+    {
+        m_frame_gaps.fetch_add(1, std::memory_order_relaxed);
+
+        // A lower frame number means the sensor or the replay restarted, nothing is missed then
+        if (frame_number > m_last_frame_number)
+            m_frames_missed.fetch_add(frame_number - m_last_frame_number - 1, std::memory_order_relaxed);
+    }
+
+    m_last_frame_number = frame_number;
+}
+
+void Telemetry::frameProcessed()
+{
+    m_frames_processed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Telemetry::updateSerialStatistics(quint64 received_bytes, quint64 resyncs)
+{
+    m_serial_received_bytes.store(received_bytes, std::memory_order_relaxed);
+    m_serial_resyncs.store(resyncs, std::memory_order_relaxed);
+}
+
+void Telemetry::updateTemperature(qint32 millicelsius)
+{
+    m_temperature.store(millicelsius, std::memory_order_relaxed);
+    m_temperature_valid.store(true, std::memory_order_relaxed);
+}
+
+void Telemetry::guiFrameRendered()
+{
+    m_gui_frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Telemetry::guiFrameSkipped()
+{
+    m_gui_frames_skipped.fetch_add(1, std::memory_order_relaxed);
+}
+
+TelemetrySnapshot_t Telemetry::snapshot() const
+{
+    TelemetrySnapshot_t s;
+    s.frames_received = m_frames_received.load(std::memory_order_relaxed);
+    s.frame_gaps = m_frame_gaps.load(std::memory_order_relaxed);
+    s.frames_missed = m_frames_missed.load(std::memory_order_relaxed);
+    s.frames_processed = m_frames_processed.load(std::memory_order_relaxed);
+    s.serial_received_bytes = m_serial_received_bytes.load(std::memory_order_relaxed);
+    s.serial_resyncs = m_serial_resyncs.load(std::memory_order_relaxed);
+    s.gui_frames = m_gui_frames.load(std::memory_order_relaxed);
+    s.gui_frames_skipped = m_gui_frames_skipped.load(std::memory_order_relaxed);
+    s.temperature_valid = m_temperature_valid.load(std::memory_order_relaxed);
+    s.temperature = m_temperature.load(std::memory_order_relaxed) / 1000.0;
+    return s;
+}
@@ -0,0 +1,58 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <QtGlobal>
+#include <atomic>
+
+struct TelemetrySnapshot_t
+{
+    quint64 frames_received;
+    quint64 frame_gaps;             // Discontinuities of the frame number
+    quint64 frames_missed;          // Frame numbers skipped by these discontinuities
+    quint64 frames_processed;       // Frames of which the range data was calculated
+    quint64 serial_received_bytes;
+    quint64 serial_resyncs;
+    quint64 gui_frames;
+    quint64 gui_frames_skipped;
+    bool temperature_valid;
+    double temperature;             // Degree celsius
+};
+
+// Counters and gauges of the acquisition and the gui, exported by the metrics server
+class Telemetry
+{
+public:
+    static Telemetry & instance();
+
+    // Acquisition thread
+    void frameReceived(quint32 frame_number);
+    void frameProcessed();
+    void updateSerialStatistics(quint64 received_bytes, quint64 resyncs);
+    void updateTemperature(qint32 millicelsius);
+
+    // Gui thread
+    void guiFrameRendered();
+    void guiFrameSkipped();
+
+    TelemetrySnapshot_t snapshot() const;
+
+private:
+    Telemetry();
+
+private:
+    std::atomic<quint64> m_frames_received;
+    std::atomic<quint64> m_frame_gaps;
+    std::atomic<quint64> m_frames_missed;
+    std::atomic<quint64> m_frames_processed;
+    std::atomic<quint64> m_serial_received_bytes;
+    std::atomic<quint64> m_serial_resyncs;
+    std::atomic<quint64> m_gui_frames;
+    std::atomic<quint64> m_gui_frames_skipped;
+    std::atomic<bool> m_temperature_valid;
+    std::atomic<qint32> m_temperature;
+
+    // Acquisition thread
+    quint32 m_last_frame_number;
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,188 @@
+#include "tracerecorder.h"
+
+#include <QDebug>
+#include <QFile>
+
+TraceRecorder::TraceRecorder()
+{
+    m_enabled = false;
+    m_settings.duration = 10.0;
+    m_settings.events_per_thread = 1 << 16;
+}
+
+TraceRecorder & TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+void TraceRecorder::setSettings(const TraceSettings_t &settings)
+{
+    QMutexLocker locker(&m);
+    m_settings = settings;
+
+    if (m_settings.events_per_thread == 0)
+        m_settings.events_per_thread = 1;
+}
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::setThreadName(const QString &name)
+{
+    if (!isEnabled())
+        return;
+
+    auto buffer = threadBuffer();
+    QMutexLocker locker(&m);
+    buffer->name = name;
+}
+
+void TraceRecorder::begin(const char *name, qint64 timestamp_ns)
+{
+    record(name, 'B', timestamp_ns, 0);
+}
+
+void TraceRecorder::end(const char *name, qint64 timestamp_ns)
+{
+    record(name, 'E', timestamp_ns, 0);
+}
+
+void TraceRecorder::complete(const char *name, qint64 begin_ns, qint64 end_ns)
+{
+    record(name, 'X', begin_ns, end_ns - begin_ns);
+}
+
+TraceRecorder::ThreadBuffer_t *TraceRecorder::threadBuffer()
+{
+    // Buffers outlive their threads, so their events can still be dumped
+    thread_local ThreadBuffer_t * buffer = nullptr;
+    if (buffer != nullptr)
+        return buffer;
+
+    QMutexLocker locker(&m);
+    std::unique_ptr<ThreadBuffer_t> b(new ThreadBuffer_t);
+    b->id = static_cast<quint32>(m_buffers.size()) + 1;
+    b->name = QString("Thread %1").arg(b->id);
+    b->events.resize(m_settings.events_per_thread);
+    b->write_index = 0;
+
+    buffer = b.get();
+    m_buffers.push_back(std::move(b));
+    return buffer;
+}
+
+void TraceRecorder::record(const char *name, char phase, qint64 timestamp_ns, qint64 duration_ns)
+{
+    if (!isEnabled())
+        return;
+
+    auto buffer = threadBuffer();
+    auto index = buffer->write_index.load(std::memory_order_relaxed);
+
+    auto & event = buffer->events[index % buffer->events.size()];
+    event.timestamp_ns = timestamp_ns;
+    event.duration_ns = duration_ns;
+    event.name = name;
+    event.phase = phase;
+
+    buffer->write_index.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::collect(const ThreadBuffer_t &buffer, qint64 since_ns, std::vector<TraceEvent_t> &events) const
+{
+    auto capacity = buffer.events.size();
+    auto end = buffer.write_index.load(std::memory_order_acquire);
+    auto begin = end > capacity ? end - capacity : 0;
+
+    events.clear();
+    for (auto i = begin; i < end; i++)
+        events.push_back(buffer.events[i % capacity]);
+
+    // Events the writer overwrote or was writing while they were copied are discarded
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto written = buffer.write_index.load(std::memory_order_relaxed) - begin;
+    if (written >= capacity)
+        events.erase(events.begin(), events.begin() + qMin<size_t>(written - capacity + 1, events.size()));
+
+    // Only the last seconds, and no end events whose begin is cut off
+    std::vector<TraceEvent_t> filtered;
+    size_t depth = 0;
+    for (auto const & e : events)
+    {
+        if (e.timestamp_ns < since_ns)
+            continue;
+
+        if (e.phase == 'B')
+            depth++;
+        else if (e.phase == 'E')
+        {
+            if (depth == 0)
+                continue;
+            depth--;
+        }
+
+        filtered.push_back(e);
+    }
+    events.swap(filtered);
+}
+
+bool TraceRecorder::dump(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "Error while opening trace file" << path << ":" << file.errorString();
+        return false;
+    }
+
+    QMutexLocker locker(&m);
+    auto since = monotonicTimestamp() - static_cast<qint64>(m_settings.duration * 1e9);
+
+    QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    auto first = true;
+    auto count = 0;
+    std::vector<TraceEvent_t> events;
+
+    for (auto const & buffer : m_buffers)
+    {
+        if (!first)
+            json.append(",\n");
+        first = false;
+
+        json.append(QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%1,\"args\":{\"name\":\"%2\"}}")
+                        .arg(buffer->id)
+                        .arg(buffer->name)
+                        .toUtf8());
+
+        collect(*buffer, since, events);
+        for (auto const & e : events)
+        {
+            json.append(QString(",\n{\"name\":\"%1\",\"ph\":\"%2\",\"pid\":1,\"tid\":%3,\"ts\":%4")
+                            .arg(e.name)
+                            .arg(e.phase)
+                            .arg(buffer->id)
+                            .arg(e.timestamp_ns / 1e3, 0, 'f', 3)
+                            .toUtf8());
+
+            if (e.phase == 'X')
+                json.append(QString(",\"dur\":%1").arg(e.duration_ns / 1e3, 0, 'f', 3).toUtf8());
+
+            json.append("}");
+        }
+        count += events.size();
+    }
+
+    json.append("\n]}\n");
+
+    if (file.write(json) != json.size())
+    {
+        qWarning() << "Error while writing trace file" << path << ":" << file.errorString();
+        return false;
+    }
+
+    qInfo() << "Wrote" << count << "trace events to" << path;
+    return true;
+}
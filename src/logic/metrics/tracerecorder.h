@@ -0,0 +1,92 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <misc/clock.h>
+
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+struct TraceEvent_t
+{
+    qint64 timestamp_ns;
+    qint64 duration_ns;     // Only for complete events
+    char const * name;      // Static string, e.g. a literal
+    char phase;             // 'B' begin, 'E' end, 'X' complete
+};
+
+struct TraceSettings_t
+{
+    double duration;            // Seconds of events written by a dump
+    quint32 events_per_thread;  // Capacity of the ring of every thread
+};
+
+// Records begin and end events of every thread into a ring per thread, disabled by default. Each ring has a
+// single writer and is read only by dumps, so recording doesn't lock. Dumps write the events of the last
+// seconds in the Chrome trace event format, which chrome://tracing and Perfetto can open.
+class TraceRecorder
+{
+public:
+    static TraceRecorder & instance();
+
+    // Settings have to be set before enabling the recorder
+    void setSettings(TraceSettings_t const & settings);
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    void setThreadName(QString const & name);
+
+    void begin(char const * name, qint64 timestamp_ns = monotonicTimestamp());
+    void end(char const * name, qint64 timestamp_ns = monotonicTimestamp());
+    void complete(char const * name, qint64 begin_ns, qint64 end_ns);
+
+    bool dump(QString const & path);
+
+private:
+    struct ThreadBuffer_t
+    {
+        quint32 id;
+        QString name;
+        std::vector<TraceEvent_t> events;
+        std::atomic<quint64> write_index;
+    };
+
+    TraceRecorder();
+    ThreadBuffer_t * threadBuffer();
+    void record(char const * name, char phase, qint64 timestamp_ns, qint64 duration_ns);
+    void collect(ThreadBuffer_t const & buffer, qint64 since_ns, std::vector<TraceEvent_t> & events) const;
+
+private:
+    std::atomic<bool> m_enabled;
+    TraceSettings_t m_settings;
+    QMutex m;
+    std::vector<std::unique_ptr<ThreadBuffer_t>> m_buffers;
+};
+
+// Records the lifetime of the scope as a span
+class TraceScope
+{
+public:
+    explicit TraceScope(char const * name)
+        : m_name(TraceRecorder::instance().isEnabled() ? name : nullptr)
+    {
+        if (m_name != nullptr)
+            TraceRecorder::instance().begin(m_name);
+    }
+
+    ~TraceScope()
+    {
+        if (m_name != nullptr)
+            TraceRecorder::instance().end(m_name);
+    }
+
+    TraceScope(TraceScope const &) = delete;
+    TraceScope & operator=(TraceScope const &) = delete;
+
+private:
+    char const * m_name;
+};
+
+#endif // TRACERECORDER_H
@@ -0,0 +1,209 @@
+#include "pipeline.h"
+
+#include <logic/metrics/latencymetrics.h>
+#include <logic/metrics/telemetry.h>
+#include <logic/metrics/tracerecorder.h>
+#include <logic/streaming/streamprotocol.h>
+
+#include <QDebug>
+
+Pipeline::Pipeline(QObject *parent) : QObject(parent)
+{
+    m_recorder = nullptr;
+    m_stream_server = nullptr;
+    m_shared_memory_ring = nullptr;
+    m_history = nullptr;
+    m_consumer_count = 0;
+}
+
+void Pipeline::setRecorder(RecordingWriter *recorder)
+{
+    m_recorder = recorder;
+}
+
+void Pipeline::setStreamServer(StreamServer *server)
+{
+    m_stream_server = server;
+}
+
+void Pipeline::setSharedMemoryRing(SharedMemoryRing *ring)
+{
+    m_shared_memory_ring = ring;
+}
+
+void Pipeline::setHistory(HistoryRing *history)
+{
+    m_history = history;
+}
+
+void Pipeline::setSignalProcessorSettings(const SignalProcessorSettings_t &settings)
+{
+    m_signal_processor_settings.put(settings);
+}
+
+int Pipeline::addConsumer(quint32 stages)
+{
+    if (m_consumer_count == PIPELINE_MAX_CONSUMERS)
+    {
+        qWarning() << "Pipeline: Too many consumers.";
+        return -1;
+    }
+
+    m_consumer_stages[m_consumer_count] = stages;
+    m_consumer_demands[m_consumer_count] = stages;
+    return m_consumer_count++;
+}
+
+void Pipeline::setConsumerActive(int consumer, bool active)
+{
+    if (consumer < 0 || consumer >= m_consumer_count)
+        return;
+
+    m_consumer_demands[consumer].store(active ? m_consumer_stages[consumer] : 0, std::memory_order_relaxed);
+}
+
+quint32 Pipeline::demand() const
+{
+    quint32 demand = 0;
+    for (auto i = 0; i < m_consumer_count; i++)
+        demand |= m_consumer_demands[i].load(std::memory_order_relaxed);
+
+    if (m_stream_server != nullptr)
+    {
+        if (m_stream_server->isSubscribed(STREAM_TOPIC_RANGE_DATA))
+            demand |= PIPELINE_STAGE_RANGE_DATA;
+        if (m_stream_server->isSubscribed(STREAM_TOPIC_MAXIMA))
+            demand |= PIPELINE_STAGE_MAXIMA;
+    }
+
+    // Readers of the shared memory ring are unknown to the writer
+    if (m_shared_memory_ring != nullptr)
+        demand |= PIPELINE_STAGE_RANGE_DATA | PIPELINE_STAGE_MAXIMA;
+
+    return demand;
+}
+
+void Pipeline::processFrame(const Frame_Info_t &frame_info, qint64 timestamp_ns)
+{
+    TraceScope trace("processFrame");
+
+    // Replays pass recorded timestamps, so the stage is timed from its own begin
+    auto & metrics = LatencyMetrics::instance();
+    auto begin = metrics.isEnabled() ? monotonicTimestamp() : 0;
+
+    Telemetry::instance().frameReceived(frame_info.frame_number);
+
+    if (auto settings = m_signal_processor_settings.take())
+        m_signal_processor.setSettings(*settings);
+
+    if (m_recorder != nullptr)
+        m_recorder->writeFrame(frame_info, timestamp_ns);
+
+    if (m_stream_server != nullptr)
+        m_stream_server->publishFrame(frame_info, timestamp_ns);
+
+    if (m_shared_memory_ring != nullptr)
+        m_shared_memory_ring->publishFrame(frame_info, timestamp_ns);
+
+    auto demand = this->demand();
+    DataPoints_t re_rx1, im_rx1, re_rx2, im_rx2;
+    if (demand & (PIPELINE_STAGE_TIME_DATA | PIPELINE_STAGE_RANGE_DATA | PIPELINE_STAGE_MAXIMA))
+        splitSamples(frame_info, re_rx1, im_rx1, re_rx2, im_rx2);
+
+    if (demand & PIPELINE_STAGE_TIME_DATA)
+        emit timeDataChanged(re_rx1, im_rx1, re_rx2, im_rx2, timestamp_ns);
+
+    if (begin != 0)
+        metrics.record(LatencyStage_t::FrameCallback, monotonicTimestamp() - begin);
+
+    processRangeData(frame_info, re_rx1, im_rx1, re_rx2, im_rx2, demand, timestamp_ns);
+}
+
+void Pipeline::processTargets(const Targets_t &targets, qint64 timestamp_ns)
+{
+    if (m_recorder != nullptr)
+        m_recorder->writeTargets(targets, timestamp_ns);
+
+    if (m_stream_server != nullptr)
+        m_stream_server->publishTargets(targets, timestamp_ns);
+
+    if (m_shared_memory_ring != nullptr)
+        m_shared_memory_ring->publishTargets(targets, timestamp_ns);
+
+    if (m_history != nullptr)
+        m_history->writeTargets(targets);
+
+    if (demand() & PIPELINE_STAGE_TARGETS)
+        emit targetDataChanged(targets, timestamp_ns);
+}
+
+void Pipeline::splitSamples(const Frame_Info_t &frame_info, DataPoints_t &re_rx1, DataPoints_t &im_rx1, DataPoints_t &re_rx2, DataPoints_t &im_rx2)
+{
+    for (uint32_t i = 0; i < 4 * frame_info.num_samples_per_chirp; i++)
+    {
+        if (i < frame_info.num_samples_per_chirp)
+        {
+            QPointF p(i, frame_info.sample_data[i]);
+            re_rx1.push_back(p);
+        }
+        else if(i < 2 * frame_info.num_samples_per_chirp)
+        {
+            QPointF p(i % frame_info.num_samples_per_chirp, frame_info.sample_data[i]);
+            im_rx1.push_back(p);
+        }
+        else if(i < 3 * frame_info.num_samples_per_chirp)
+        {
+            QPointF p(i % (2 * frame_info.num_samples_per_chirp), frame_info.sample_data[i]);
+            re_rx2.push_back(p);
+        }
+        else
+        {
+            QPointF p(i % (3 * frame_info.num_samples_per_chirp), frame_info.sample_data[i]);
+            im_rx2.push_back(p);
+        }
+    }
+}
+
+void Pipeline::processRangeData(const Frame_Info_t &frame_info, const DataPoints_t &re_rx1, const DataPoints_t &im_rx1, const DataPoints_t &re_rx2, const DataPoints_t &im_rx2, quint32 demand, qint64 timestamp_ns)
+{
+    DataPoints_t rx1, rx2, maxima;
+    auto maximum = 0.0;
+    auto range_demanded = (demand & (PIPELINE_STAGE_RANGE_DATA | PIPELINE_STAGE_MAXIMA)) != 0;
+
+    if (range_demanded)
+    {
+        LatencyScope scope(LatencyStage_t::Fft);
+        rx1 = m_signal_processor.calculateRangeData(re_rx1, im_rx1);
+        rx2 = m_signal_processor.calculateRangeData(re_rx2, im_rx2);
+        Telemetry::instance().frameProcessed();
+    }
+
+    if (demand & PIPELINE_STAGE_MAXIMA)
+    {
+        LatencyScope scope(LatencyStage_t::Persistence);
+        maxima = m_signal_processor.calculateMaxima(rx1, maximum);
+    }
+
+    // The history player calculates the spectrum of browsed frames itself, stored maxima may be empty
+    if (m_history != nullptr)
+        m_history->writeFrame(frame_info, maxima, maximum, timestamp_ns);
+
+    if (!range_demanded)
+        return;
+
+    LatencyScope scope(LatencyStage_t::Emit);
+
+    if (m_stream_server != nullptr)
+    {
+        m_stream_server->publishRangeData(rx1, rx2, timestamp_ns);
+        m_stream_server->publishMaxima(maxima, maximum, timestamp_ns);
+    }
+
+    if (m_shared_memory_ring != nullptr)
+    {
+        m_shared_memory_ring->publishRangeData(rx1, rx2, timestamp_ns);
+        m_shared_memory_ring->publishMaxima(maxima, maximum, timestamp_ns);
+    }
+
+    emit rangeDataChanged(rx1, rx2, maxima, maximum, timestamp_ns);
+}
@@ -0,0 +1,71 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <misc/mailbox.h>
+#include <misc/types.h>
+#include <logic/history/historyring.h>
+#include <logic/signalprocessor/signalprocessor.h>
+#include <logic/recording/recordingwriter.h>
+#include <logic/streaming/streamserver.h>
+#include <logic/streaming/sharedmemoryring.h>
+
+#include <EndpointRadarBase.h>
+#include <QObject>
+#include <atomic>
+
+// Stages a consumer of the pipeline can ask for. Forwarding the raw frames and targets to the recorder,
+// stream server, shared memory ring and history always runs.
+constexpr quint32 PIPELINE_STAGE_TIME_DATA = 1 << 0;   // timeDataChanged
+constexpr quint32 PIPELINE_STAGE_RANGE_DATA = 1 << 1;  // rangeDataChanged with the range spectrum
+constexpr quint32 PIPELINE_STAGE_MAXIMA = 1 << 2;      // rangeDataChanged with the maxima of antenna 1
+constexpr quint32 PIPELINE_STAGE_TARGETS = 1 << 3;     // targetDataChanged
+constexpr auto PIPELINE_MAX_CONSUMERS = 16;
+
+class Pipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit Pipeline(QObject *parent = nullptr);
+
+    void setRecorder(RecordingWriter *recorder);
+    void setStreamServer(StreamServer *server);
+    void setSharedMemoryRing(SharedMemoryRing *ring);
+    void setHistory(HistoryRing *history);
+
+    // Can be called while processing, the settings are applied before the next frame
+    void setSignalProcessorSettings(SignalProcessorSettings_t const & settings);
+
+    // Consumers register the stages they need before processing starts and can be (de)activated anytime,
+    // stages without an active consumer are skipped. Returns -1 if there are too many consumers.
+    int addConsumer(quint32 stages);
+    void setConsumerActive(int consumer, bool active);
+    quint32 demand() const;
+
+    void processFrame(Frame_Info_t const & frame_info, qint64 timestamp_ns);
+    void processTargets(Targets_t const & targets, qint64 timestamp_ns);
+
+    static void splitSamples(Frame_Info_t const & frame_info, DataPoints_t & re_rx1, DataPoints_t & im_rx1, DataPoints_t & re_rx2, DataPoints_t & im_rx2);
+
+signals:
+    // The trailing timestamp is the monotonic acquisition time of the frame, slots may leave it out
+    void timeDataChanged(DataPoints_t const & re_rx1, DataPoints_t const & im_rx1, DataPoints_t const & re_rx2, DataPoints_t const & im_rx2, qint64 timestamp_ns);
+    void rangeDataChanged(DataPoints_t const & rx1, DataPoints_t const & rx2, DataPoints_t const & maxima, double const & max_y, qint64 timestamp_ns);
+    void targetDataChanged(Targets_t const & data, qint64 timestamp_ns);
+
+private:
+    void processRangeData(Frame_Info_t const & frame_info, DataPoints_t const & re_rx1, DataPoints_t const & im_rx1, DataPoints_t const & re_rx2, DataPoints_t const & im_rx2, quint32 demand, qint64 timestamp_ns);
+
+private:
+    RecordingWriter *m_recorder;
+    StreamServer *m_stream_server;
+    SharedMemoryRing *m_shared_memory_ring;
+    HistoryRing *m_history;
+    SignalProcessor m_signal_processor;
+    Mailbox<SignalProcessorSettings_t> m_signal_processor_settings;
+    quint32 m_consumer_stages[PIPELINE_MAX_CONSUMERS];
+    std::atomic<quint32> m_consumer_demands[PIPELINE_MAX_CONSUMERS];
+    int m_consumer_count;
+};
+
+#endif // PIPELINE_H
@@ -1,6 +1,10 @@
 #include "radar.h"
 
+#include <misc/clock.h>
 #include <misc/constants.h>
+#include <logic/metrics/latencymetrics.h>
+#include <logic/metrics/telemetry.h>
+#include <logic/metrics/tracerecorder.h>
 #include <COMPort.h>
 #include <EndpointCalibration.h>
 #include <EndpointRadarAdcxmc.h>
@@ -11,8 +15,13 @@
 #include <EndpointRadarIndustrial.h>
 #include <EndpointRadarP2G.h>
 #include <QDebug>
+#include <QFile>
+#include <QLoggingCategory>
 #include <QThread>
 
+// Logging category of the radar, its status messages are logged in every measurement cycle
+Q_LOGGING_CATEGORY(radar_category, "p2g.radar")
+
 // Constants
 constexpr auto STATE_RADAR_DISCONNECTED = -1;
 
@@ -22,38 +31,57 @@ void CbReceivedTargetData(void* context, int32_t handle, uint8_t endpoint, const
 void CbTemperature(void *context, int32_t handle, uint8_t endpoint, uint8_t temp_sensor, int32_t temperature);
 void CbGetFrameFormat(void *context, int32_t protocol_handle, uint8_t endpoint, const Frame_Format_t *frame_format);
 void CbGetDspSettings(void *context, int32_t protocol_handle, uint8_t endpoint, const DSP_Settings_t *dsp_settings);
+void CbProtocolStage(void *context, Protocol_Stage_t stage, uint8_t begin);
+
+// Last port a radar was connected to, kept across restarts
+static QString readLastPort()
+{
+    QFile file(LAST_PORT_FILE_PATH);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return QString();
 
-Radar::Radar(QObject *parent) : QObject(parent)
+    return QString::fromUtf8(file.readLine()).trimmed();
+}
+
+static void writeLastPort(QString const & port)
+{
+    if (readLastPort() == port)
+        return;
+
+    QFile file(LAST_PORT_FILE_PATH);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        qCWarning(radar_category) << "Failed to store the last port:" << file.errorString();
+        return;
+    }
+
+    file.write(port.toUtf8() + "\n");
+}
+
+Radar::Radar(QObject *parent) : FrameSource(parent), m_commands(RADAR_COMMAND_QUEUE_CAPACITY)
 {
     m_handle = STATE_RADAR_DISCONNECTED;
     m_shutdown = false;
+    m_read_begin = 0;
+    m_read_end = 0;
+    m_parse_begin = 0;
 }
 
 Radar::~Radar()
 {}
 
-bool Radar::connect()
+bool Radar::connect(bool probe_unidentified)
 {
     QMutexLocker locker(&m);
 
-    qInfo() << "Trying to connect to radar...";
+    qCInfo(radar_category) << "Trying to connect to radar...";
 
-    const auto infos = QSerialPortInfo::availablePorts();
+    const auto infos = candidatePorts(probe_unidentified);
     for (const QSerialPortInfo &info : infos)
     {
-        #ifdef __linux__
-            m_handle = protocol_connect(("/dev/" + info.portName()).toStdString().c_str());
-        #elif _WIN32
-            m_handle = protocol_connect(info.portName().toStdString().c_str());
-        #endif
-
-        if (m_handle >= 0)
+        if (probePort(info))
         {
-            qInfo() << "Device found.";
-            printSerialPortInformation(info);
-            if (!checkFirmwareInformation(RADAR_EXPECTED_FIRMWARE_VERSION))
-                return false;
-
+            writeLastPort(info.portName());
             setCallbackFunctions();
             m_shutdown = false;
             emit connectionChanged(true);
@@ -61,7 +89,7 @@ bool Radar::connect()
         }
     }
 
-    qInfo() << "No devices found...";
+    qCInfo(radar_category) << "No devices found...";
     return false;
 }
 
@@ -79,7 +107,7 @@ void Radar::disconnect()
 
     m_handle = STATE_RADAR_DISCONNECTED;
     emit connectionChanged(false);
-    qInfo() << "Device succesfully disconnected.";
+    qCInfo(radar_category) << "Device succesfully disconnected.";
 }
 
 bool Radar::addEndpoint(const EndpointType_t &endpoint)
@@ -174,19 +202,39 @@ bool Radar::setAutomaticFrameTrigger(bool enable, const EndpointType_t &endpoint
     return true;
 }
 
+void Radar::run()
+{
+    doMeasurement();
+}
+
+void Radar::stop()
+{
+    disconnect();
+}
+
 void Radar::doMeasurement()
 {
     while(true)
     {
-        m.lock();
-        if (m_shutdown)
-            break;
+        {
+            TraceScope trace("doMeasurement");
+
+            m.lock();
+            if (m_shutdown)
+                break;
 
-        auto res = true;
-        res &= getStatusCodeInformation("Get temperature", ep_radar_base_get_temperature(m_handle, m_endpoints[EndpointType_t::Base], 0));
-        res &= getStatusCodeInformation("Get frame data", ep_radar_base_get_frame_data(m_handle, m_endpoints[EndpointType_t::Base], 0));
-        res &= getStatusCodeInformation("Get target data", ep_targetdetect_get_targets(m_handle, m_endpoints[EndpointType_t::TargetDetection]));
-        m.unlock();
+            executeCommands();
+
+            auto res = true;
+            res &= getStatusCodeInformation("Get temperature", ep_radar_base_get_temperature(m_handle, m_endpoints[EndpointType_t::Base], 0));
+            res &= getStatusCodeInformation("Get frame data", ep_radar_base_get_frame_data(m_handle, m_endpoints[EndpointType_t::Base], 0));
+            res &= getStatusCodeInformation("Get target data", ep_targetdetect_get_targets(m_handle, m_endpoints[EndpointType_t::TargetDetection]));
+
+            Protocol_Statistics_t statistics;
+            protocol_get_statistics(&statistics);
+            Telemetry::instance().updateSerialStatistics(statistics.received_bytes, statistics.resyncs);
+            m.unlock();
+        }
 
         QThread::msleep(RADAR_MEASUREMENT_PAUSE_TIME);
     }
@@ -195,66 +243,132 @@ void Radar::doMeasurement()
 
 void Radar::getFrameFormat()
 {
-    QMutexLocker locker(&m);
-    getStatusCodeInformation("Get frame format", ep_radar_base_get_frame_format(m_handle, m_endpoints[EndpointType_t::Base]));
+    queueCommand({RadarCommandType_t::GetFrameFormat, {}, {}});
 }
 
 void Radar::setFrameFormat(const Frame_Format_t &frame_format)
 {
-    QMutexLocker locker(&m);
-    getStatusCodeInformation("Set frame format", ep_radar_base_set_frame_format(m_handle, m_endpoints[EndpointType_t::Base], &frame_format));
+    queueCommand({RadarCommandType_t::SetFrameFormat, frame_format, {}});
 }
 
 void Radar::getDspSettings()
 {
-    QMutexLocker locker(&m);
-    getStatusCodeInformation("Get DSP settings", ep_targetdetect_get_dsp_settings(m_handle, m_endpoints[EndpointType_t::TargetDetection]));
+    queueCommand({RadarCommandType_t::GetDspSettings, {}, {}});
 }
 
 void Radar::setDspSettings(const DSP_Settings_t &dsp_settings)
 {
-    QMutexLocker locker(&m);
-    getStatusCodeInformation("Set DSP settings", ep_targetdetect_set_dsp_settings(m_handle, m_endpoints[EndpointType_t::TargetDetection], &dsp_settings));
+    queueCommand({RadarCommandType_t::SetDspSettings, {}, dsp_settings});
 }
 
-void Radar::emitRangeDataSignal(const DataPoints_t &re_rx1, const DataPoints_t &im_rx1, const DataPoints_t &re_rx2, const DataPoints_t &im_rx2)
+void Radar::updateProtocolStage(Protocol_Stage_t stage, bool begin)
 {
+    auto & trace = TraceRecorder::instance();
+    if (!LatencyMetrics::instance().isEnabled() && !trace.isEnabled())
+        return;
 
-    auto rx1 = m_signal_processor.calculateRangeData(re_rx1, im_rx1);
-    auto rx2 = m_signal_processor.calculateRangeData(re_rx2, im_rx2);
+    auto timestamp = monotonicTimestamp();
+    char const * name = nullptr;
 
-    std::vector<float> data;
+    switch (stage)
+    {
+        case PROTOCOL_STAGE_GET_MESSAGE:
+            if (begin)
+                m_read_begin = timestamp;
+            else
+                m_read_end = timestamp;
+            name = "get_message";
+        break;
+
+        case PROTOCOL_STAGE_PARSE_PAYLOAD:
+            if (begin)
+                m_parse_begin = timestamp;
+            name = "parse_payload";
+        break;
+
+        case PROTOCOL_STAGE_SEND_AND_RECEIVE:
+            name = "protocol_send_and_receive";
+        break;
+    }
 
-    for (auto i = 0; i < rx1.size(); i++)
-        data.push_back(rx1[i].y());
+    if (name == nullptr)
+        return;
 
-    m_persistence.RunPersistence(data);
+    if (begin)
+        trace.begin(name, timestamp);
+    else
+        trace.end(name, timestamp);
+}
 
-    std::vector<p1d::TPairedExtrema> extrema;
-    m_persistence.GetPairedExtrema(extrema, 0.01);
+void Radar::recordFrameTiming(qint64 timestamp_ns)
+{
+    if (m_parse_begin == 0)
+        return;
 
-    auto maximum = 0.0;
-    DataPoints_t maxima;
+    // The frame callback is the last step of parse_frame_info
+    TraceRecorder::instance().complete("parse_frame_info", m_parse_begin, timestamp_ns);
 
-    for(auto it = extrema.begin(); it != extrema.end(); it++)
+    auto & metrics = LatencyMetrics::instance();
+    metrics.record(LatencyStage_t::SerialRead, m_read_end - m_read_begin);
+    metrics.record(LatencyStage_t::PayloadParse, timestamp_ns - m_parse_begin);
+}
+
+QList<QSerialPortInfo> Radar::candidatePorts(bool probe_unidentified) const
+{
+    // Only ports of a Position2Go are probed, every other port would cost a handshake timeout. Ports
+    // without USB identifiers are probed as a last resort, e.g. if the driver doesn't report them.
+    QList<QSerialPortInfo> candidates;
+    QList<QSerialPortInfo> unidentified;
+    auto last_port = readLastPort();
+
+    const auto infos = QSerialPortInfo::availablePorts();
+    for (const QSerialPortInfo &info : infos)
     {
-        auto x = rx1[(*it).MaxIndex].x();
-        auto y = rx1[(*it).MaxIndex].y();
+        // The port of the last connection is tried first, even without USB identifiers
+        if (!last_port.isEmpty() && info.portName() == last_port)
+            candidates.prepend(info);
+        else if (!info.hasVendorIdentifier() || !info.hasProductIdentifier())
+            unidentified.append(info);
+        else if (info.vendorIdentifier() == RADAR_USB_VENDOR_ID && info.productIdentifier() == RADAR_USB_PRODUCT_ID)
+            candidates.append(info);
+    }
+
+    if (probe_unidentified)
+        candidates.append(unidentified);
 
-        maxima.append(QPointF(x, y));
+    return candidates;
+}
+
+bool Radar::probePort(const QSerialPortInfo &info)
+{
+    #ifdef __linux__
+        m_handle = protocol_connect(("/dev/" + info.portName()).toStdString().c_str());
+    #elif _WIN32
+        m_handle = protocol_connect(info.portName().toStdString().c_str());
+    #endif
 
-        if (y > maximum)
-            maximum = y;
+    if (m_handle < 0)
+    {
+        m_handle = STATE_RADAR_DISCONNECTED;
+        return false;
     }
 
-    emit rangeDataChanged(rx1, rx2, maxima, maximum);
+    qCInfo(radar_category) << "Device found.";
+    printSerialPortInformation(info);
+    if (!checkFirmwareInformation(RADAR_EXPECTED_FIRMWARE_VERSION))
+    {
+        protocol_disconnect(m_handle);
+        m_handle = STATE_RADAR_DISCONNECTED;
+        return false;
+    }
+    return true;
 }
 
 void Radar::printSerialPortInformation(const QSerialPortInfo &info)
 {
-    qInfo() << "Port: " <<  info.portName();
-    qInfo() << "Vendor Identifier: " << (info.hasVendorIdentifier() ? QString::number(info.vendorIdentifier(), 16) : QString());
-    qInfo() << "Product Identifier: " << (info.hasProductIdentifier() ? QString::number(info.productIdentifier(), 16) : QString());
+    qCInfo(radar_category) << "Port: " <<  info.portName();
+    qCInfo(radar_category) << "Vendor Identifier: " << (info.hasVendorIdentifier() ? QString::number(info.vendorIdentifier(), 16) : QString());
+    qCInfo(radar_category) << "Product Identifier: " << (info.hasProductIdentifier() ? QString::number(info.productIdentifier(), 16) : QString());
     emit serialPortChanged(info.portName());
 }
 
@@ -268,12 +382,12 @@ bool Radar::checkFirmwareInformation(QString const & version)
 
         if (v != version)
         {
-            qWarning() << "Firmware version doesn't match: Expected: " << version << "- Current version: " << v;
+            qCWarning(radar_category) << "Firmware version doesn't match: Expected: " << version << "- Current version: " << v;
             return false;
         }
 
-        qInfo() << "Description: " << description;
-        qInfo() << "Firmware: " << v;
+        qCInfo(radar_category) << "Description: " << description;
+        qCInfo(radar_category) << "Firmware: " << v;
         emit firmwareInformationChanged(description, v);
         return true;
     }
@@ -286,62 +400,85 @@ bool Radar::getStatusCodeInformation(QString const & origin, int code)
 
     if ((code & 0xFFFF) != PROTOCOL_STATUS_OK)
     {
-        qWarning() << origin << ":" << ret;
+        qCWarning(radar_category) << origin << ":" << ret;
         return false;
     }
 
-    qInfo() << origin << ":" << ret;
+    qCInfo(radar_category) << origin << ":" << ret;
     return true;
 }
 
 void Radar::setCallbackFunctions()
 {
-    qInfo() << "Setting callback functions...";
+    qCInfo(radar_category) << "Setting callback functions...";
 
     ep_radar_base_set_callback_data_frame(CbReceivedFrameData, this);
     ep_targetdetect_set_callback_target_processing(CbReceivedTargetData, this);
     ep_radar_base_set_callback_temperature(CbTemperature, this);
     ep_radar_base_set_callback_frame_format(CbGetFrameFormat, this);
     ep_targetdetect_set_callback_dsp_settings(CbGetDspSettings, this);
+    protocol_set_callback_stage(CbProtocolStage, this);
 }
 
-void CbReceivedFrameData(void* context, int32_t, uint8_t, const Frame_Info_t* frame_info)
+void Radar::queueCommand(const RadarCommand_t &command)
 {
-    if (frame_info == nullptr)
-        return;
-
-    DataPoints_t re_rx1, im_rx1, re_rx2, im_rx2;
+    auto queued = command;
+    if (!m_commands.tryPush(std::move(queued)))
+        qCWarning(radar_category) << "Command queue is full, dropping the command.";
+}
 
-    for (uint32_t i = 0; i < 4 * frame_info->num_samples_per_chirp; i++)
+void Radar::executeCommands()
+{
+    RadarCommand_t command;
+    while (m_commands.tryPop(command))
     {
-        if (i < frame_info->num_samples_per_chirp)
-        {
-            QPointF p(i, frame_info->sample_data[i]);
-            re_rx1.push_back(p);
-        }
-        else if(i < 2 * frame_info->num_samples_per_chirp)
-        {
-            QPointF p(i % frame_info->num_samples_per_chirp, frame_info->sample_data[i]);
-            im_rx1.push_back(p);
-        }
-        else if(i < 3 * frame_info->num_samples_per_chirp)
-        {
-            QPointF p(i % (2 * frame_info->num_samples_per_chirp), frame_info->sample_data[i]);
-            re_rx2.push_back(p);
-        }
-        else
+        TraceScope trace("executeCommand");
+
+        QString name;
+        int code = 0;
+        switch (command.type)
         {
-            QPointF p(i % (3 * frame_info->num_samples_per_chirp), frame_info->sample_data[i]);
-            im_rx2.push_back(p);
+            case RadarCommandType_t::GetFrameFormat:
+                name = "Get frame format";
+                code = ep_radar_base_get_frame_format(m_handle, m_endpoints[EndpointType_t::Base]);
+            break;
+
+            case RadarCommandType_t::SetFrameFormat:
+                name = "Set frame format";
+                code = ep_radar_base_set_frame_format(m_handle, m_endpoints[EndpointType_t::Base], &command.frame_format);
+            break;
+
+            case RadarCommandType_t::GetDspSettings:
+                name = "Get DSP settings";
+                code = ep_targetdetect_get_dsp_settings(m_handle, m_endpoints[EndpointType_t::TargetDetection]);
+            break;
+
+            case RadarCommandType_t::SetDspSettings:
+                name = "Set DSP settings";
+                code = ep_targetdetect_set_dsp_settings(m_handle, m_endpoints[EndpointType_t::TargetDetection], &command.dsp_settings);
+            break;
         }
+
+        emit commandExecuted(name, getStatusCodeInformation(name, code));
     }
+}
+
+void CbReceivedFrameData(void* context, int32_t, uint8_t, const Frame_Info_t* frame_info)
+{
+    auto timestamp = monotonicTimestamp();
+    if (frame_info == nullptr)
+        return;
 
-    emit ((Radar*)context)->timeDataChanged(re_rx1, im_rx1, re_rx2, im_rx2);
-    ((Radar*)context)->emitRangeDataSignal(re_rx1, im_rx1, re_rx2, im_rx2);
+    ((Radar*)context)->recordFrameTiming(timestamp);
+
+    auto pipeline = ((Radar*)context)->pipeline();
+    if (pipeline != nullptr)
+        pipeline->processFrame(*frame_info, timestamp);
 }
 
 void CbReceivedTargetData(void* context, int32_t, uint8_t, const  Target_Info_t* target_info, uint8_t num_targets)
 {
+    auto timestamp = monotonicTimestamp();
     if (target_info == nullptr)
         return;
 
@@ -349,7 +486,9 @@ void CbReceivedTargetData(void* context, int32_t, uint8_t, const  Target_Info_t*
     vec.reserve(num_targets);
     std::copy(target_info, target_info + num_targets, std::back_inserter(vec));
 
-    emit ((Radar*)context)->targetDataChanged(vec);
+    auto pipeline = ((Radar*)context)->pipeline();
+    if (pipeline != nullptr)
+        pipeline->processTargets(vec, timestamp);
 }
 
 void CbTemperature(void * context, int32_t, uint8_t, uint8_t, int32_t temperature)
@@ -357,6 +496,8 @@ void CbTemperature(void * context, int32_t, uint8_t, uint8_t, int32_t temperatur
     if (temperature <= 0)
         return;
 
+    Telemetry::instance().updateTemperature(temperature);
+
     auto temp = QString::number(temperature/1000.0,'f',2);
     emit ((Radar*)context)->temperatureChanged(temp);
 }
@@ -376,3 +517,8 @@ void CbGetDspSettings(void *context, int32_t, uint8_t, const DSP_Settings_t *dsp
 
     emit ((Radar*)context)->dspSettingsChanged(*dsp_settings);
 }
+
+void CbProtocolStage(void *context, Protocol_Stage_t stage, uint8_t begin)
+{
+    ((Radar*)context)->updateProtocolStage(stage, begin != 0);
+}
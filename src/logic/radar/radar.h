@@ -1,20 +1,35 @@
 #ifndef RADAR_H
 #define RADAR_H
 
+#include <misc/mpscqueue.h>
 #include <misc/types.h>
-#include <logic/signalprocessor/signalprocessor.h>
+#include <logic/framesource/framesource.h>
 
-#include <persistence1d.hpp>
 #include <Protocol.h>
 #include <EndpointRadarBase.h>
 #include <EndpointTargetDetection.h>
 #include <QtSerialPort/QSerialPortInfo>
-#include <QObject>
 #include <QMap>
 #include <QMutex>
 
+enum class RadarCommandType_t
+{
+    GetFrameFormat,
+    SetFrameFormat,
+    GetDspSettings,
+    SetDspSettings
+};
+
+struct RadarCommand_t
+{
+    RadarCommandType_t type;
+    Frame_Format_t frame_format;
+    DSP_Settings_t dsp_settings;
+};
 
-class Radar : public QObject
+// The measurement loop runs on the acquisition thread. Commands from other threads are only queued and
+// executed by that loop between two exchanges with the sensor, so callers never wait for the serial port.
+class Radar : public FrameSource
 {
     Q_OBJECT
 
@@ -22,43 +37,55 @@ public:
     explicit Radar(QObject *parent = nullptr);
     ~Radar();
 
-    bool connect();
+    // Ports without USB identifiers cost a handshake timeout each, so they are only probed if asked for
+    bool connect(bool probe_unidentified = true);
     bool addEndpoint(EndpointType_t const & endpoint);
     bool setAutomaticFrameTrigger(bool enable, EndpointType_t const & endpoint, size_t interval_us);
-    void emitRangeDataSignal(DataPoints_t const & re_rx1, DataPoints_t const & im_rx1, DataPoints_t const & re_rx2, DataPoints_t const & im_rx2);
 
 public slots:
+    void run() override;
+    void stop() override;
     void disconnect();
     void doMeasurement();
+
+    // Can be called from any thread, the results are emitted by frameFormatChanged, dspSettingsChanged
+    // and commandExecuted
     void getFrameFormat();
     void setFrameFormat(Frame_Format_t const & frame_format);
     void getDspSettings();
     void setDspSettings(DSP_Settings_t const & dsp_settings);
 
+public:
+    void updateProtocolStage(Protocol_Stage_t stage, bool begin);
+    void recordFrameTiming(qint64 timestamp_ns);
+
 signals:
-    void timeDataChanged(DataPoints_t const & re_rx1, DataPoints_t const & im_rx1, DataPoints_t const & re_rx2, DataPoints_t const & im_rx2);
-    void rangeDataChanged(DataPoints_t const & rx1, DataPoints_t const & rx2, DataPoints_t const & maxima, double const & max_y);
-    void targetDataChanged(Targets_t const & data);
     void firmwareInformationChanged(QString const & description, QString const & version);
     void serialPortChanged(QString const & port);
     void temperatureChanged(QString const & temperature);
-    void connectionChanged(bool connected);
     void frameFormatChanged(Frame_Format_t const & frame_format);
     void dspSettingsChanged(DSP_Settings_t const & dsp_settings);
+    void commandExecuted(QString const & command, bool success);
 
 private:
+    QList<QSerialPortInfo> candidatePorts(bool probe_unidentified) const;
+    bool probePort(QSerialPortInfo const & info);
     void printSerialPortInformation(QSerialPortInfo const & info);
     bool checkFirmwareInformation(QString const & version);
     bool getStatusCodeInformation(QString const & origin, int code);
     void setCallbackFunctions();
+    void queueCommand(RadarCommand_t const & command);
+    void executeCommands();
 
 private:
     int m_handle;
     bool m_shutdown;
     QMutex m;
     QMap<EndpointType_t, int> m_endpoints;
-    SignalProcessor m_signal_processor;
-    p1d::Persistence1D m_persistence;
+    MpscQueue<RadarCommand_t> m_commands;
+    qint64 m_read_begin;
+    qint64 m_read_end;
+    qint64 m_parse_begin;
 };
 
 #endif // RADAR_H
@@ -0,0 +1,66 @@
+#include "recordingformat.h"
+
+#include <cmath>
+
+size_t alignChunkSize(size_t size)
+{
+    return (size + RECORDING_CHUNK_ALIGNMENT - 1) & ~static_cast<size_t>(RECORDING_CHUNK_ALIGNMENT - 1);
+}
+
+uint32_t totalSampleCount(const Frame_Info_t &frame_info)
+{
+    return frame_info.num_chirps *
+           frame_info.num_samples_per_chirp *
+           frame_info.num_rx_antennas *
+           (frame_info.data_format == EP_RADAR_BASE_RX_DATA_REAL ? 1 : 2);
+}
+
+size_t packedSampleSize(uint32_t num_samples, uint8_t adc_resolution)
+{
+    return (static_cast<size_t>(num_samples) * adc_resolution + 7) / 8;
+}
+
+void packAdcSamples(const float *samples, uint32_t num_samples, uint8_t adc_resolution, uint8_t *out)
+{
+    const uint32_t sample_bit_mask = (1u << adc_resolution) - 1;
+    uint64_t bits = 0;
+    uint32_t num_bits = 0;
+
+    for (uint32_t i = 0; i < num_samples; i++)
+    {
+        auto code = static_cast<uint32_t>(std::lrint(samples[i] * sample_bit_mask)) & sample_bit_mask;
+        bits |= static_cast<uint64_t>(code) << num_bits;
+        num_bits += adc_resolution;
+
+        while (num_bits >= 8)
+        {
+            *out++ = static_cast<uint8_t>(bits);
+            bits >>= 8;
+            num_bits -= 8;
+        }
+    }
+
+    if (num_bits > 0)
+        *out = static_cast<uint8_t>(bits);
+}
+
+void unpackAdcSamples(const uint8_t *packed, uint32_t num_samples, uint8_t adc_resolution, float *out)
+{
+    const uint32_t sample_bit_mask = (1u << adc_resolution) - 1;
+    const float norm_factor = 1.f / (float)sample_bit_mask;
+    uint64_t bits = 0;
+    uint32_t num_bits = 0;
+
+    for (uint32_t i = 0; i < num_samples; i++)
+    {
+        while (num_bits < adc_resolution)
+        {
+            bits |= static_cast<uint64_t>(*packed++) << num_bits;
+            num_bits += 8;
+        }
+
+        *out++ = (bits & sample_bit_mask) * norm_factor;
+        bits >>= adc_resolution;
+        num_bits -= adc_resolution;
+    }
+}
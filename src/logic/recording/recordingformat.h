@@ -0,0 +1,95 @@
+#ifndef RECORDINGFORMAT_H
+#define RECORDINGFORMAT_H
+
+#include <EndpointRadarBase.h>
+#include <EndpointTargetDetection.h>
+#include <cstddef>
+#include <cstdint>
+
+// Layout of a recording (all fields little endian, every chunk 8 byte aligned):
+//
+//   RecordingFileHeader_t
+//   { ChunkHeader_t, FrameChunk_t + packed ADC codes | TargetsChunk_t + Target_Info_t[] } ...
+//   ChunkHeader_t, IndexEntry_t[]      (one entry per frame chunk)
+//   RecordingFooter_t                  (locates the index, absent if the recording wasn't closed)
+
+constexpr char RECORDING_MAGIC[8] = {'P', '2', 'G', 'R', 'E', 'C', '0', '1'};
+constexpr uint32_t RECORDING_VERSION = 1;
+constexpr uint32_t RECORDING_CHUNK_ALIGNMENT = 8;
+
+enum class ChunkType_t : uint32_t
+{
+    Frame = 1,
+    Targets = 2,
+    Index = 3
+};
+
+struct RecordingFileHeader_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    int64_t created_utc_ms;
+};
+
+struct ChunkHeader_t
+{
+    uint32_t type;
+    uint32_t size;  // Size of the chunk body including padding, without this header
+};
+
+struct FrameChunk_t
+{
+    int64_t timestamp_ns;
+    uint32_t frame_number;
+    uint32_t num_chirps;
+    uint32_t num_samples_per_chirp;
+    uint8_t num_rx_antennas;
+    uint8_t rx_mask;
+    uint8_t adc_resolution;
+    uint8_t interleaved_rx;
+    uint8_t data_format;
+    uint8_t reserved[3];
+    uint32_t num_samples;   // Followed by the packed ADC codes of all samples
+};
+
+struct TargetsChunk_t
+{
+    int64_t timestamp_ns;
+    uint32_t frame_number;  // Number of the frame preceding these targets
+    uint32_t num_targets;   // Followed by num_targets * Target_Info_t
+};
+
+struct IndexEntry_t
+{
+    uint64_t offset;        // File offset of the frame's ChunkHeader_t
+    int64_t timestamp_ns;
+    uint32_t frame_number;
+    uint32_t reserved;
+};
+
+struct RecordingFooter_t
+{
+    uint64_t index_offset;  // File offset of the index' ChunkHeader_t
+    uint64_t num_entries;
+    char magic[8];
+};
+
+static_assert(sizeof(RecordingFileHeader_t) == 24, "Unexpected recording header layout");
+static_assert(sizeof(ChunkHeader_t) == 8, "Unexpected chunk header layout");
+static_assert(sizeof(FrameChunk_t) == 32, "Unexpected frame chunk layout");
+static_assert(sizeof(TargetsChunk_t) == 16, "Unexpected targets chunk layout");
+static_assert(sizeof(Target_Info_t) == 32, "Unexpected target layout");
+static_assert(sizeof(IndexEntry_t) == 24, "Unexpected index entry layout");
+static_assert(sizeof(RecordingFooter_t) == 24, "Unexpected recording footer layout");
+
+size_t alignChunkSize(size_t size);
+uint32_t totalSampleCount(Frame_Info_t const & frame_info);
+size_t packedSampleSize(uint32_t num_samples, uint8_t adc_resolution);
+
+// The sensor transmits the ADC codes bit packed, ComLib expands them to normalized floats.
+// Packing reverses that expansion exactly, unpacking reproduces the very same floats.
+void packAdcSamples(float const * samples, uint32_t num_samples, uint8_t adc_resolution, uint8_t * out);
+void unpackAdcSamples(uint8_t const * packed, uint32_t num_samples, uint8_t adc_resolution, float * out);
+
+#endif // RECORDINGFORMAT_H
@@ -0,0 +1,202 @@
+#include "recordingreader.h"
+
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+RecordingReader::RecordingReader()
+{
+    m_data = nullptr;
+    m_size = 0;
+    m_index = nullptr;
+    m_index_size = 0;
+}
+
+RecordingReader::~RecordingReader()
+{
+    close();
+}
+
+bool RecordingReader::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Error while opening recording:" << path;
+        return false;
+    }
+
+    // Map the whole file, pages are only loaded once a frame is actually accessed
+    m_size = m_file.size();
+    m_data = m_size >= sizeof(RecordingFileHeader_t) ? m_file.map(0, m_size) : nullptr;
+    if (m_data == nullptr)
+    {
+        qWarning() << "Error while mapping recording:" << path;
+        close();
+        return false;
+    }
+
+    auto header = reinterpret_cast<const RecordingFileHeader_t*>(m_data);
+    if (memcmp(header->magic, RECORDING_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != RECORDING_VERSION)
+    {
+        qWarning() << "Unsupported recording format:" << path;
+        close();
+        return false;
+    }
+
+    if (!loadIndex())
+    {
+        qWarning() << "Recording wasn't closed properly, rebuilding index:" << path;
+        rebuildIndex();
+    }
+
+    return true;
+}
+
+void RecordingReader::close()
+{
+    if (m_data != nullptr)
+        m_file.unmap(m_data);
+
+    if (m_file.isOpen())
+        m_file.close();
+
+    m_data = nullptr;
+    m_size = 0;
+    m_index = nullptr;
+    m_index_size = 0;
+    m_rebuilt_index.clear();
+}
+
+bool RecordingReader::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+size_t RecordingReader::frameCount() const
+{
+    return m_index_size;
+}
+
+size_t RecordingReader::findFrameNumber(uint32_t frame_number) const
+{
+    // Frame numbers only increase as long as the sensor's frame counter isn't reset during the recording
+    auto it = std::lower_bound(m_index, m_index + m_index_size, frame_number,
+                               [](IndexEntry_t const & e, uint32_t n) { return e.frame_number < n; });
+    return it - m_index;
+}
+
+size_t RecordingReader::findTimestamp(qint64 timestamp_ns) const
+{
+    auto it = std::lower_bound(m_index, m_index + m_index_size, timestamp_ns,
+                               [](IndexEntry_t const & e, qint64 t) { return e.timestamp_ns < t; });
+    return it - m_index;
+}
+
+bool RecordingReader::frame(size_t index, RecordedFrameView_t &view) const
+{
+    if (index >= m_index_size)
+        return false;
+
+    auto offset = m_index[index].offset;
+    auto chunk = chunkAt(offset);
+    if (chunk == nullptr || chunk->type != static_cast<uint32_t>(ChunkType_t::Frame) || chunk->size < sizeof(FrameChunk_t))
+        return false;
+
+    view.frame = reinterpret_cast<const FrameChunk_t*>(chunk + 1);
+    view.packed_samples = reinterpret_cast<const uint8_t*>(view.frame + 1);
+    view.targets = nullptr;
+    view.num_targets = 0;
+    view.targets_timestamp_ns = 0;
+
+    // Reject frames whose samples would reach beyond the chunk
+    if (view.frame->adc_resolution == 0 || view.frame->adc_resolution > 16 ||
+        packedSampleSize(view.frame->num_samples, view.frame->adc_resolution) > chunk->size - sizeof(FrameChunk_t))
+        return false;
+
+    auto next = chunkAt(offset + sizeof(ChunkHeader_t) + chunk->size);
+    if (next != nullptr && next->type == static_cast<uint32_t>(ChunkType_t::Targets) && next->size >= sizeof(TargetsChunk_t))
+    {
+        auto targets = reinterpret_cast<const TargetsChunk_t*>(next + 1);
+        view.targets = reinterpret_cast<const Target_Info_t*>(targets + 1);
+        view.num_targets = qMin<size_t>(targets->num_targets, (next->size - sizeof(TargetsChunk_t)) / sizeof(Target_Info_t));
+        view.targets_timestamp_ns = targets->timestamp_ns;
+    }
+
+    return true;
+}
+
+void RecordingReader::unpack(const RecordedFrameView_t &view, std::vector<float> &samples, Frame_Info_t &frame_info) const
+{
+    samples.resize(view.frame->num_samples);
+    unpackAdcSamples(view.packed_samples, view.frame->num_samples, view.frame->adc_resolution, samples.data());
+
+    frame_info.sample_data = samples.data();
+    frame_info.frame_number = view.frame->frame_number;
+    frame_info.num_chirps = view.frame->num_chirps;
+    frame_info.num_rx_antennas = view.frame->num_rx_antennas;
+    frame_info.num_samples_per_chirp = view.frame->num_samples_per_chirp;
+    frame_info.rx_mask = view.frame->rx_mask;
+    frame_info.adc_resolution = view.frame->adc_resolution;
+    frame_info.interleaved_rx = view.frame->interleaved_rx;
+    frame_info.data_format = static_cast<Rx_Data_Format_t>(view.frame->data_format);
+}
+
+bool RecordingReader::loadIndex()
+{
+    if (m_size < sizeof(RecordingFileHeader_t) + sizeof(RecordingFooter_t))
+        return false;
+
+    auto footer = reinterpret_cast<const RecordingFooter_t*>(m_data + m_size - sizeof(RecordingFooter_t));
+    if (memcmp(footer->magic, RECORDING_MAGIC, sizeof(footer->magic)) != 0)
+        return false;
+
+    auto chunk = chunkAt(footer->index_offset);
+    if (chunk == nullptr || chunk->type != static_cast<uint32_t>(ChunkType_t::Index) ||
+        chunk->size / sizeof(IndexEntry_t) < footer->num_entries)
+        return false;
+
+    m_index = reinterpret_cast<const IndexEntry_t*>(chunk + 1);
+    m_index_size = footer->num_entries;
+    return true;
+}
+
+void RecordingReader::rebuildIndex()
+{
+    quint64 offset = reinterpret_cast<const RecordingFileHeader_t*>(m_data)->header_size;
+
+    while (auto chunk = chunkAt(offset))
+    {
+        if (chunk->type == static_cast<uint32_t>(ChunkType_t::Frame) && chunk->size >= sizeof(FrameChunk_t))
+        {
+            auto frame = reinterpret_cast<const FrameChunk_t*>(chunk + 1);
+
+            IndexEntry_t entry;
+            entry.offset = offset;
+            entry.timestamp_ns = frame->timestamp_ns;
+            entry.frame_number = frame->frame_number;
+            entry.reserved = 0;
+            m_rebuilt_index.push_back(entry);
+        }
+        offset += sizeof(ChunkHeader_t) + chunk->size;
+    }
+
+    m_index = m_rebuilt_index.data();
+    m_index_size = m_rebuilt_index.size();
+}
+
+const ChunkHeader_t *RecordingReader::chunkAt(quint64 offset) const
+{
+    // Chunks which are misaligned or not completely inside the file are treated as the end of the recording
+    if (offset % RECORDING_CHUNK_ALIGNMENT != 0 || offset + sizeof(ChunkHeader_t) > m_size)
+        return nullptr;
+
+    auto chunk = reinterpret_cast<const ChunkHeader_t*>(m_data + offset);
+    if (chunk->size > m_size - offset - sizeof(ChunkHeader_t))
+        return nullptr;
+
+    return chunk;
+}
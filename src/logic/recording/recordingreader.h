@@ -0,0 +1,50 @@
+#ifndef RECORDINGREADER_H
+#define RECORDINGREADER_H
+
+#include <misc/types.h>
+#include <logic/recording/recordingformat.h>
+
+#include <QFile>
+#include <vector>
+
+// Zero-copy view into the mapped recording, valid as long as the reader stays open
+struct RecordedFrameView_t
+{
+    FrameChunk_t const * frame;
+    uint8_t const * packed_samples;
+    Target_Info_t const * targets;  // Targets recorded right after the frame, nullptr if there are none
+    uint32_t num_targets;
+    qint64 targets_timestamp_ns;
+};
+
+class RecordingReader
+{
+public:
+    RecordingReader();
+    ~RecordingReader();
+
+    bool open(QString const & path);
+    void close();
+    bool isOpen() const;
+
+    size_t frameCount() const;
+    size_t findFrameNumber(uint32_t frame_number) const;
+    size_t findTimestamp(qint64 timestamp_ns) const;
+    bool frame(size_t index, RecordedFrameView_t & view) const;
+    void unpack(RecordedFrameView_t const & view, std::vector<float> & samples, Frame_Info_t & frame_info) const;
+
+private:
+    bool loadIndex();
+    void rebuildIndex();
+    ChunkHeader_t const * chunkAt(quint64 offset) const;
+
+private:
+    QFile m_file;
+    uchar *m_data;
+    quint64 m_size;
+    IndexEntry_t const *m_index;
+    size_t m_index_size;
+    std::vector<IndexEntry_t> m_rebuilt_index;
+};
+
+#endif // RECORDINGREADER_H
@@ -0,0 +1,411 @@
+#include "recordingwriter.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <cstring>
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// Constants
+constexpr size_t RECORDING_BLOCK_SIZE = 4 << 20;
+constexpr size_t RECORDING_BLOCK_ALIGNMENT = 4096;
+constexpr quint64 RECORDING_PREALLOCATION_SIZE = 64 << 20;
+constexpr size_t RECORDING_SLOT_RESERVE = 4096;
+constexpr auto RECORDING_IDLE_WAIT = 2;
+
+RecordingWriter::RecordingWriter()
+{
+    m_thread = nullptr;
+    m_shutdown = false;
+    m_last_frame_number = 0;
+    m_block = nullptr;
+    m_block_used = 0;
+    m_block_offset = 0;
+    m_preallocated = 0;
+    m_preallocation_supported = true;
+    m_file_number = 0;
+    m_file_first_timestamp = -1;
+    m_frames_written = 0;
+    m_frames_dropped = 0;
+    m_targets_dropped = 0;
+    m_backpressure_events = 0;
+    m_backpressure = false;
+    m_bytes_written = 0;
+    m_files_written = 0;
+}
+
+RecordingWriter::~RecordingWriter()
+{
+    close();
+}
+
+bool RecordingWriter::open(const QString &path, const RecordingSettings_t &settings)
+{
+    close();
+
+    m_path = path;
+    m_settings = settings;
+    m_file_number = 0;
+    m_block = static_cast<uint8_t*>(qMallocAligned(RECORDING_BLOCK_SIZE, RECORDING_BLOCK_ALIGNMENT));
+
+    if (!openFile())
+    {
+        qFreeAligned(m_block);
+        m_block = nullptr;
+        return false;
+    }
+
+    // Reserve the slots up front, so the acquisition thread doesn't allocate in steady state
+    m_queue.reset(new SpscQueue<RecordingSlot_t>(settings.queue_capacity));
+    for (auto & slot : m_queue->slots())
+        slot.chunk.reserve(RECORDING_SLOT_RESERVE);
+
+    m_shutdown = false;
+    m_thread = QThread::create([this]() { writerLoop(); });
+    m_thread->setObjectName("RecordingWriter");
+    m_thread->start();
+
+    qInfo() << "Recording to" << m_file.fileName();
+    return true;
+}
+
+void RecordingWriter::close()
+{
+    if (m_thread == nullptr)
+        return;
+
+    // The writer thread drains the queue before it finalizes the file
+    m_shutdown = true;
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+
+    closeFile();
+    qFreeAligned(m_block);
+    m_block = nullptr;
+    m_queue.reset();
+
+    auto s = statistics();
+    qInfo() << "Recording closed:" << s.frames_written << "frames in" << s.files_written << "file(s),"
+            << s.frames_dropped << "frames dropped," << s.backpressure_events << "backpressure events.";
+}
+
+bool RecordingWriter::isOpen() const
+{
+    return m_thread != nullptr;
+}
+
+void RecordingWriter::writeFrame(const Frame_Info_t &frame_info, qint64 timestamp_ns)
+{
+    if (m_thread == nullptr || frame_info.sample_data == nullptr)
+        return;
+
+    auto num_samples = totalSampleCount(frame_info);
+    auto packed_size = packedSampleSize(num_samples, frame_info.adc_resolution);
+
+    auto slot = acquireSlot(ChunkType_t::Frame, sizeof(FrameChunk_t) + packed_size);
+    if (slot == nullptr)
+    {
+        m_frames_dropped++;
+        return;
+    }
+
+    FrameChunk_t chunk;
+    chunk.timestamp_ns = timestamp_ns;
+    chunk.frame_number = frame_info.frame_number;
+    chunk.num_chirps = frame_info.num_chirps;
+    chunk.num_samples_per_chirp = frame_info.num_samples_per_chirp;
+    chunk.num_rx_antennas = frame_info.num_rx_antennas;
+    chunk.rx_mask = frame_info.rx_mask;
+    chunk.adc_resolution = frame_info.adc_resolution;
+    chunk.interleaved_rx = frame_info.interleaved_rx;
+    chunk.data_format = frame_info.data_format;
+    memset(chunk.reserved, 0, sizeof(chunk.reserved));
+    chunk.num_samples = num_samples;
+
+    auto body = slot->chunk.data() + sizeof(ChunkHeader_t);
+    memcpy(body, &chunk, sizeof(chunk));
+    packAdcSamples(frame_info.sample_data, num_samples, frame_info.adc_resolution, body + sizeof(chunk));
+
+    slot->timestamp_ns = timestamp_ns;
+    slot->frame_number = frame_info.frame_number;
+    m_last_frame_number = frame_info.frame_number;
+    commitSlot();
+}
+
+void RecordingWriter::writeTargets(const Targets_t &targets, qint64 timestamp_ns)
+{
+    if (m_thread == nullptr)
+        return;
+
+    auto targets_size = static_cast<size_t>(targets.size()) * sizeof(Target_Info_t);
+
+    auto slot = acquireSlot(ChunkType_t::Targets, sizeof(TargetsChunk_t) + targets_size);
+    if (slot == nullptr)
+    {
+        m_targets_dropped++;
+        return;
+    }
+
+    TargetsChunk_t chunk;
+    chunk.timestamp_ns = timestamp_ns;
+    chunk.frame_number = m_last_frame_number;
+    chunk.num_targets = targets.size();
+
+    auto body = slot->chunk.data() + sizeof(ChunkHeader_t);
+    memcpy(body, &chunk, sizeof(chunk));
+    if (targets_size > 0)
+        memcpy(body + sizeof(chunk), targets.constData(), targets_size);
+
+    slot->timestamp_ns = timestamp_ns;
+    slot->frame_number = m_last_frame_number;
+    commitSlot();
+}
+
+RecordingStatistics_t RecordingWriter::statistics() const
+{
+    RecordingStatistics_t s;
+    s.frames_written = m_frames_written;
+    s.frames_dropped = m_frames_dropped;
+    s.targets_dropped = m_targets_dropped;
+    s.backpressure_events = m_backpressure_events;
+    s.bytes_written = m_bytes_written;
+    s.queue_depth = m_queue ? m_queue->size() : 0;
+    s.files_written = m_files_written;
+    return s;
+}
+
+RecordingSlot_t *RecordingWriter::acquireSlot(ChunkType_t type, size_t body_size)
+{
+    auto slot = m_queue->acquire();
+    if (slot == nullptr)
+        return nullptr;
+
+    // A queue filled up to three quarters means the disk doesn't keep up with the sensor. Each stall
+    // counts once, until the queue drained below again.
+    auto backpressure = m_queue->size() >= m_queue->capacity() * 3 / 4;
+    if (backpressure && !m_backpressure)
+        m_backpressure_events++;
+    m_backpressure = backpressure;
+
+    auto aligned_size = alignChunkSize(body_size);
+
+    ChunkHeader_t header;
+    header.type = static_cast<uint32_t>(type);
+    header.size = aligned_size;
+
+    slot->type = type;
+    slot->chunk.resize(sizeof(header) + aligned_size);
+    memcpy(slot->chunk.data(), &header, sizeof(header));
+    // Zero the padding, so recordings are reproducible byte by byte
+    memset(slot->chunk.data() + sizeof(header) + body_size, 0, aligned_size - body_size);
+
+    return slot;
+}
+
+void RecordingWriter::commitSlot()
+{
+    m_queue->commit();
+}
+
+void RecordingWriter::writerLoop()
+{
+    quint64 reported_drops = 0;
+
+    while (true)
+    {
+        auto slot = m_queue->front();
+        if (slot == nullptr)
+        {
+            if (m_shutdown)
+                break;
+
+            auto drops = m_frames_dropped.load();
+            if (drops != reported_drops)
+            {
+                qWarning() << "Recording can't keep up:" << drops - reported_drops << "frames dropped.";
+                reported_drops = drops;
+            }
+
+            QThread::msleep(RECORDING_IDLE_WAIT);
+            continue;
+        }
+
+        writeSlot(*slot);
+        m_queue->pop();
+    }
+}
+
+void RecordingWriter::writeSlot(const RecordingSlot_t &slot)
+{
+    if (slot.type == ChunkType_t::Frame)
+    {
+        if (needsRotation(slot))
+        {
+            closeFile();
+            m_file_number++;
+            openFile();
+        }
+
+        if (!m_file.isOpen())
+            return;
+
+        if (m_file_first_timestamp < 0)
+            m_file_first_timestamp = slot.timestamp_ns;
+
+        IndexEntry_t entry;
+        entry.offset = m_block_offset + m_block_used;
+        entry.timestamp_ns = slot.timestamp_ns;
+        entry.frame_number = slot.frame_number;
+        entry.reserved = 0;
+        m_index.append(entry);
+        m_frames_written++;
+    }
+
+    if (m_file.isOpen())
+        append(slot.chunk.data(), slot.chunk.size());
+}
+
+bool RecordingWriter::needsRotation(const RecordingSlot_t &slot) const
+{
+    if (m_index.isEmpty())
+        return false;
+
+    if (m_settings.max_file_size > 0 && m_block_offset + m_block_used >= m_settings.max_file_size)
+        return true;
+
+    if (m_settings.max_file_duration > 0 && m_file_first_timestamp >= 0 &&
+        slot.timestamp_ns - m_file_first_timestamp >= m_settings.max_file_duration * 1000000000)
+        return true;
+
+    return false;
+}
+
+bool RecordingWriter::openFile()
+{
+    m_file.setFileName(filePath(m_file_number));
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered))
+    {
+        qWarning() << "Error while opening recording file:" << m_file.fileName();
+        return false;
+    }
+
+    m_block_used = 0;
+    m_block_offset = 0;
+    m_preallocated = 0;
+    m_file_first_timestamp = -1;
+    m_index.clear();
+
+    RecordingFileHeader_t header;
+    memcpy(header.magic, RECORDING_MAGIC, sizeof(header.magic));
+    header.version = RECORDING_VERSION;
+    header.header_size = sizeof(RecordingFileHeader_t);
+    header.created_utc_ms = QDateTime::currentMSecsSinceEpoch();
+    append(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+
+    if (m_file_number > 0)
+        qInfo() << "Recording rotated to" << m_file.fileName();
+
+    return true;
+}
+
+void RecordingWriter::closeFile()
+{
+    if (!m_file.isOpen())
+        return;
+
+    auto index_offset = m_block_offset + m_block_used;
+    auto index_size = static_cast<size_t>(m_index.size()) * sizeof(IndexEntry_t);
+
+    ChunkHeader_t header;
+    header.type = static_cast<uint32_t>(ChunkType_t::Index);
+    header.size = index_size;
+    append(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    append(reinterpret_cast<const uint8_t*>(m_index.constData()), index_size);
+
+    RecordingFooter_t footer;
+    footer.index_offset = index_offset;
+    footer.num_entries = m_index.size();
+    memcpy(footer.magic, RECORDING_MAGIC, sizeof(footer.magic));
+    append(reinterpret_cast<const uint8_t*>(&footer), sizeof(footer));
+
+    writeBlock(m_block_used);
+
+#ifdef __linux__
+    // Space preallocated beyond the end of the file stays allocated until it is truncated explicitly
+    if (m_preallocated > 0)
+    {
+        m_file.flush();
+        if (ftruncate(m_file.handle(), m_block_offset) != 0)
+            qWarning() << "Error while releasing the preallocated space of the recording:" << strerror(errno);
+    }
+#endif
+
+    m_file.close();
+    m_files_written++;
+}
+
+void RecordingWriter::append(const uint8_t *data, size_t size)
+{
+    while (size > 0)
+    {
+        auto n = qMin(size, RECORDING_BLOCK_SIZE - m_block_used);
+        memcpy(m_block + m_block_used, data, n);
+        m_block_used += n;
+        data += n;
+        size -= n;
+
+        // Only complete, aligned blocks are written while recording
+        if (m_block_used == RECORDING_BLOCK_SIZE)
+            writeBlock(RECORDING_BLOCK_SIZE);
+    }
+}
+
+void RecordingWriter::writeBlock(size_t size)
+{
+    if (size == 0)
+        return;
+
+    preallocate();
+
+    if (m_file.write(reinterpret_cast<const char*>(m_block), size) != static_cast<qint64>(size))
+        qWarning() << "Error while writing recording:" << m_file.errorString();
+
+    m_bytes_written += size;
+    m_block_offset += size;
+    m_block_used = 0;
+}
+
+void RecordingWriter::preallocate()
+{
+#ifdef __linux__
+    // Reserve the disk space in large steps, so the file system doesn't need to allocate on every block
+    if (!m_preallocation_supported || m_block_offset + RECORDING_BLOCK_SIZE <= m_preallocated)
+        return;
+
+    if (fallocate(m_file.handle(), FALLOC_FL_KEEP_SIZE, m_preallocated, RECORDING_PREALLOCATION_SIZE) != 0)
+    {
+        qWarning() << "File system doesn't support preallocation, recording continues without.";
+        m_preallocation_supported = false;
+        return;
+    }
+    m_preallocated += RECORDING_PREALLOCATION_SIZE;
+#endif
+}
+
+QString RecordingWriter::filePath(int number) const
+{
+    if (m_settings.max_file_size == 0 && m_settings.max_file_duration == 0)
+        return m_path;
+
+    QFileInfo info(m_path);
+    auto name = QString("%1_%2").arg(info.completeBaseName()).arg(number, 4, 10, QChar('0'));
+    if (!info.suffix().isEmpty())
+        name += "." + info.suffix();
+
+    return info.dir().filePath(name);
+}
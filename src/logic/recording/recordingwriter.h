@@ -0,0 +1,102 @@
+#ifndef RECORDINGWRITER_H
+#define RECORDINGWRITER_H
+
+#include <misc/types.h>
+#include <misc/spscqueue.h>
+#include <logic/recording/recordingformat.h>
+
+#include <QFile>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+struct RecordingSettings_t
+{
+    quint64 max_file_size;      // Bytes, 0 disables size based rotation
+    qint64 max_file_duration;   // Seconds, 0 disables time based rotation
+    quint32 queue_capacity;     // Chunks buffered between acquisition and writer thread
+};
+
+struct RecordingStatistics_t
+{
+    quint64 frames_written;
+    quint64 frames_dropped;
+    quint64 targets_dropped;
+    quint64 backpressure_events;    // Times the queue filled up to three quarters
+    quint64 bytes_written;
+    quint64 queue_depth;
+    quint64 files_written;
+};
+
+struct RecordingSlot_t
+{
+    ChunkType_t type;
+    qint64 timestamp_ns;
+    uint32_t frame_number;
+    std::vector<uint8_t> chunk;    // Complete chunk including its ChunkHeader_t
+};
+
+// The acquisition thread only packs each frame into a preallocated queue slot. Everything touching
+// the file runs on a dedicated writer thread, so a stalling disk costs queued or dropped frames but
+// never blocks the acquisition.
+class RecordingWriter
+{
+public:
+    RecordingWriter();
+    ~RecordingWriter();
+
+    bool open(QString const & path, RecordingSettings_t const & settings);
+    void close();
+    bool isOpen() const;
+
+    void writeFrame(Frame_Info_t const & frame_info, qint64 timestamp_ns);
+    void writeTargets(Targets_t const & targets, qint64 timestamp_ns);
+    RecordingStatistics_t statistics() const;
+
+private:
+    RecordingSlot_t * acquireSlot(ChunkType_t type, size_t body_size);
+    void commitSlot();
+
+    void writerLoop();
+    void writeSlot(RecordingSlot_t const & slot);
+    bool needsRotation(RecordingSlot_t const & slot) const;
+    bool openFile();
+    void closeFile();
+    void append(uint8_t const * data, size_t size);
+    void writeBlock(size_t size);
+    void preallocate();
+    QString filePath(int number) const;
+
+private:
+    // Shared between both threads
+    std::unique_ptr<SpscQueue<RecordingSlot_t>> m_queue;
+    QThread *m_thread;
+    std::atomic<bool> m_shutdown;
+    std::atomic<quint64> m_frames_written;
+    std::atomic<quint64> m_frames_dropped;
+    std::atomic<quint64> m_targets_dropped;
+    std::atomic<quint64> m_backpressure_events;
+    std::atomic<quint64> m_bytes_written;
+    std::atomic<quint64> m_files_written;
+
+    // Acquisition thread
+    uint32_t m_last_frame_number;
+    bool m_backpressure;
+
+    // Writer thread
+    QString m_path;
+    RecordingSettings_t m_settings;
+    QFile m_file;
+    uint8_t *m_block;
+    size_t m_block_used;
+    quint64 m_block_offset;
+    quint64 m_preallocated;
+    bool m_preallocation_supported;
+    int m_file_number;
+    qint64 m_file_first_timestamp;
+    QVector<IndexEntry_t> m_index;
+};
+
+#endif // RECORDINGWRITER_H
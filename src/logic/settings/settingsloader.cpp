@@ -1,5 +1,6 @@
 #include "settingsloader.h"
 
+#include <QDebug>
 #include <QFile>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -8,7 +9,7 @@
 SettingsLoader::SettingsLoader(QObject *parent) : QObject(parent)
 {}
 
-bool SettingsLoader::parseSettings(const QString &path, Settings_t &settings)
+bool SettingsLoader::parseSettings(const QString &path, Settings_t &settings, QJsonObject *document)
 {
     QJsonDocument data;
     if (!readFile(path, data))
@@ -32,6 +33,100 @@ bool SettingsLoader::parseSettings(const QString &path, Settings_t &settings)
     settings.dsp_settings.enable_mti_filter = dsp["MTIFilterSelection"].toInt();
     settings.dsp_settings.mti_filter_length = dsp["MTIFilterWeight"].toInt();
 
+    QJsonObject recording = json.value("Recording").toObject();
+    settings.recording_settings.max_file_size = static_cast<quint64>(recording["MaxFileSize"].toInt(0)) << 20;
+    settings.recording_settings.max_file_duration = recording["MaxFileDuration"].toInt(0);
+    settings.recording_settings.queue_capacity = recording["QueueCapacity"].toInt(1024);
+
+    QJsonObject streaming = json.value("Streaming").toObject();
+    settings.streaming_settings.local_socket = streaming["LocalSocket"].toString("p2g-dashboard");
+    settings.streaming_settings.tcp_port = streaming["TcpPort"].toInt(5730);
+    settings.streaming_settings.max_pending_bytes = static_cast<qint64>(streaming["MaxPendingData"].toInt(4)) << 20;
+
+    QJsonObject shared_memory = json.value("SharedMemory").toObject();
+    settings.shared_memory_settings.name = shared_memory["Name"].toString("/p2g-dashboard");
+    settings.shared_memory_settings.slot_count = shared_memory["SlotCount"].toInt(256);
+    settings.shared_memory_settings.slot_size = shared_memory["SlotSize"].toInt(16384);
+
+    QJsonObject tracing = json.value("Tracing").toObject();
+    settings.trace_settings.duration = tracing["Duration"].toDouble(10.0);
+    settings.trace_settings.events_per_thread = tracing["EventsPerThread"].toInt(65536);
+
+    QJsonObject metrics = json.value("Metrics").toObject();
+    settings.metrics_settings.address = metrics["Address"].toString("127.0.0.1");
+    settings.metrics_settings.port = metrics["Port"].toInt(9730);
+
+    QJsonObject logging = json.value("Logging").toObject();
+    settings.logging_settings.file = logging["File"].toString();
+    if (!AsyncLogger::levelFromName(logging["Level"].toString("Info"), settings.logging_settings.level))
+    {
+        qWarning() << "Unknown log level:" << logging["Level"].toString();
+        return false;
+    }
+    QJsonObject categories = logging["Categories"].toObject();
+    settings.logging_settings.categories.clear();
+    for (auto it = categories.begin(); it != categories.end(); it++)
+    {
+        QtMsgType level;
+        if (!AsyncLogger::levelFromName(it.value().toString(), level))
+        {
+            qWarning() << "Unknown log level of category" << it.key() << ":" << it.value().toString();
+            return false;
+        }
+        settings.logging_settings.categories.insert(it.key(), level);
+    }
+    settings.logging_settings.rate_limit = logging["RateLimit"].toInt(0);
+    settings.logging_settings.queue_capacity = logging["QueueCapacity"].toInt(4096);
+    settings.logging_settings.stderr_only = false;
+
+    QJsonObject waterfall = json.value("Waterfall").toObject();
+    settings.waterfall_settings.enabled = waterfall["Enabled"].toBool(true);
+    settings.waterfall_settings.duration = waterfall["Duration"].toDouble(30.0);
+    settings.waterfall_settings.rows_per_second = waterfall["RowsPerSecond"].toInt(20);
+    settings.waterfall_settings.min_db = waterfall["MinDb"].toDouble(-60.0);
+    settings.waterfall_settings.max_db = waterfall["MaxDb"].toDouble(0.0);
+    if (settings.waterfall_settings.duration <= 0.0 || settings.waterfall_settings.max_db <= settings.waterfall_settings.min_db)
+    {
+        qWarning() << "Invalid waterfall settings.";
+        return false;
+    }
+
+    QJsonObject history = json.value("History").toObject();
+    settings.history_settings.memory = static_cast<quint64>(history["Memory"].toInt(8)) << 20;
+
+    QJsonObject heatmap = json.value("Heatmap").toObject();
+    settings.heatmap_settings.enabled = heatmap["Enabled"].toBool(true);
+    settings.heatmap_settings.half_life = heatmap["HalfLife"].toDouble(60.0);
+    if (settings.heatmap_settings.half_life <= 0.0)
+    {
+        qWarning() << "Invalid heatmap half-life:" << settings.heatmap_settings.half_life;
+        return false;
+    }
+
+    QJsonObject hud = json.value("Hud").toObject();
+    settings.hud_settings.enabled = hud["Enabled"].toBool(false);
+
+    QJsonObject signal = json.value("SignalProcessing").toObject();
+    SignalProcessorSettings_t defaults;
+    if (!SignalProcessor::windowFromName(signal["Window"].toString("Hann"), settings.signal_processor_settings.window))
+    {
+        qWarning() << "Unknown window function:" << signal["Window"].toString();
+        return false;
+    }
+    settings.signal_processor_settings.zero_padding_factor = signal["ZeroPaddingFactor"].toInt(defaults.zero_padding_factor);
+    if (!SignalProcessor::isValidZeroPaddingFactor(settings.signal_processor_settings.zero_padding_factor))
+    {
+        qWarning() << "Zero padding factor must be a power of two";
+        return false;
+    }
+    settings.signal_processor_settings.persistence_threshold = signal["PersistenceThreshold"].toDouble(defaults.persistence_threshold);
+    settings.signal_processor_settings.cfar_guard_cells = signal["CfarGuardCells"].toInt(defaults.cfar_guard_cells);
+    settings.signal_processor_settings.cfar_training_cells = signal["CfarTrainingCells"].toInt(defaults.cfar_training_cells);
+    settings.signal_processor_settings.cfar_threshold_factor = signal["CfarThresholdFactor"].toDouble(defaults.cfar_threshold_factor);
+
+    if (document != nullptr)
+        *document = json;
+
     return true;
 }
 
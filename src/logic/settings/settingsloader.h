@@ -1,6 +1,19 @@
 #ifndef SETTINGSLOADER_H
 #define SETTINGSLOADER_H
 
+#include <gui/chart/targetdata/occupancyheatmap.h>
+#include <gui/chart/waterfall/waterfallchart.h>
+#include <gui/hud/hud.h>
+#include <logic/history/historyring.h>
+#include <logic/metrics/metricsserver.h>
+#include <logic/metrics/tracerecorder.h>
+#include <logic/recording/recordingwriter.h>
+#include <logic/signalprocessor/signalprocessor.h>
+#include <logic/streaming/streamserver.h>
+#include <logic/streaming/sharedmemoryring.h>
+#include <misc/asynclogger.h>
+
+#include <QJsonObject>
 #include <QObject>
 
 #include <EndpointTargetDetection.h>
@@ -10,6 +23,17 @@ struct Settings_t
     bool statusbar_enabled;
     bool toolbar_enabled;
     DSP_Settings_t dsp_settings;
+    RecordingSettings_t recording_settings;
+    SignalProcessorSettings_t signal_processor_settings;
+    StreamingSettings_t streaming_settings;
+    SharedMemoryRingSettings_t shared_memory_settings;
+    TraceSettings_t trace_settings;
+    MetricsSettings_t metrics_settings;
+    LoggingSettings_t logging_settings;
+    WaterfallSettings_t waterfall_settings;
+    HistorySettings_t history_settings;
+    HeatmapSettings_t heatmap_settings;
+    HudSettings_t hud_settings;
 };
 
 class SettingsLoader : public QObject
@@ -17,7 +41,8 @@ class SettingsLoader : public QObject
     Q_OBJECT
 public:
     explicit SettingsLoader(QObject *parent = nullptr);
-    bool parseSettings(QString const & path, Settings_t & settings);
+    // Optionally returns the parsed document, e.g. to find the changed sections
+    bool parseSettings(QString const & path, Settings_t & settings, QJsonObject * document = nullptr);
 
 private:
     bool readFile(QString const & path, QJsonDocument & data);
@@ -0,0 +1,92 @@
+#include "settingswatcher.h"
+
+#include <QDebug>
+#include <QFileInfo>
+
+// Constants
+constexpr auto SETTINGS_RELOAD_DELAY = 200;     // Editors write or replace the file in several steps
+
+// Sections which are only read at startup
+constexpr char const * SETTINGS_RESTART_SECTIONS[] = {
+    "StatusbarEnabled", "ToolbarEnabled", "Recording", "Streaming", "SharedMemory",
+    "Tracing", "Metrics", "Logging", "Waterfall", "History"
+};
+
+SettingsWatcher::SettingsWatcher(QObject *parent) : QObject(parent)
+{
+    m_reload_timer.setSingleShot(true);
+    m_reload_timer.setInterval(SETTINGS_RELOAD_DELAY);
+
+    QObject::connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &SettingsWatcher::fileChanged);
+    QObject::connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &SettingsWatcher::fileChanged);
+    QObject::connect(&m_reload_timer, &QTimer::timeout, this, &SettingsWatcher::reload);
+}
+
+bool SettingsWatcher::watch(const QString &path, const QJsonObject &json)
+{
+    m_path = path;
+    m_json = json;
+
+    // The directory is watched as well, as saving by rename removes the watched file
+    if (!m_watcher.addPath(m_path) || !m_watcher.addPath(QFileInfo(m_path).absolutePath()))
+    {
+        qWarning() << "Failed to watch the configuration file" << m_path;
+        return false;
+    }
+
+    return true;
+}
+
+void SettingsWatcher::fileChanged()
+{
+    m_reload_timer.start();
+}
+
+void SettingsWatcher::reload()
+{
+    if (!QFileInfo::exists(m_path))
+        return;
+
+    if (!m_watcher.files().contains(m_path))
+        m_watcher.addPath(m_path);
+
+    Settings_t settings;
+    QJsonObject json;
+    SettingsLoader loader;
+    if (!loader.parseSettings(m_path, settings, &json))
+    {
+        qWarning() << "Ignoring the changed configuration file, keeping the current settings.";
+        return;
+    }
+
+    if (json == m_json)
+        return;
+
+    auto changed = [this, &json](char const * section) { return json.value(section) != m_json.value(section); };
+
+    if (changed("DspSettings"))
+    {
+        qInfo() << "Applying the changed DSP settings.";
+        emit dspSettingsChanged(settings.dsp_settings);
+    }
+
+    if (changed("SignalProcessing"))
+    {
+        qInfo() << "Applying the changed signal processing settings.";
+        emit signalProcessorSettingsChanged(settings.signal_processor_settings);
+    }
+
+    if (changed("Heatmap"))
+        emit heatmapSettingsChanged(settings.heatmap_settings);
+
+    if (changed("Hud"))
+        emit hudSettingsChanged(settings.hud_settings);
+
+    for (auto section : SETTINGS_RESTART_SECTIONS)
+    {
+        if (changed(section))
+            qInfo() << "The changed section" << section << "takes effect with the next start.";
+    }
+
+    m_json = json;
+}
@@ -0,0 +1,41 @@
+#ifndef SETTINGSWATCHER_H
+#define SETTINGSWATCHER_H
+
+#include <logic/settings/settingsloader.h>
+
+#include <QFileSystemWatcher>
+#include <QJsonObject>
+#include <QObject>
+#include <QTimer>
+
+// Reloads the configuration file when it changes and emits the settings of the changed sections, which
+// can be applied while the frames keep streaming. Changes of other sections are only logged, they take
+// effect with the next start. An invalid file is ignored, so the last valid settings stay active.
+class SettingsWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SettingsWatcher(QObject *parent = nullptr);
+
+    // Starts watching, json is the document the current settings were parsed from
+    bool watch(QString const & path, QJsonObject const & json);
+
+signals:
+    void dspSettingsChanged(DSP_Settings_t const & dsp_settings);
+    void signalProcessorSettingsChanged(SignalProcessorSettings_t const & settings);
+    void heatmapSettingsChanged(HeatmapSettings_t const & settings);
+    void hudSettingsChanged(HudSettings_t const & settings);
+
+private slots:
+    void fileChanged();
+    void reload();
+
+private:
+    QFileSystemWatcher m_watcher;
+    QTimer m_reload_timer;
+    QString m_path;
+    QJsonObject m_json;
+};
+
+#endif // SETTINGSWATCHER_H
@@ -1,124 +1,272 @@
 #include "signalprocessor.h"
 
+#include <logic/metrics/tracerecorder.h>
+#include <QDebug>
 #include <dj_fft.h>
 #include <math.h>
 
 constexpr auto SIGNAL_SAMPLE_SIZE = 64;
-constexpr auto SIGNAL_WINDOW_SIZE = SIGNAL_SAMPLE_SIZE;
-constexpr auto SIGNAL_ZERO_PADDING_FACTOR = 4;
-constexpr auto SIGNAL_ZERO_PADDED_SIZE = SIGNAL_SAMPLE_SIZE * SIGNAL_ZERO_PADDING_FACTOR;
-constexpr auto SIGNAL_ZEROES_AMOUNT = SIGNAL_ZERO_PADDED_SIZE - SIGNAL_SAMPLE_SIZE;
-constexpr auto SIGNAL_SIZE_DISCARD_HALF = SIGNAL_ZERO_PADDED_SIZE / 2;
 
-constexpr auto RADAR_SAMPLING_FREQUENCY = 213.34 * 1e3;
-constexpr auto RADAR_RAMP_TIME_EFF = 300 * 1e-6;
-constexpr auto RADAR_BANDWITH_EFF = 200 * 1e6;
-constexpr auto SPEED_OF_LIGHT = 3 * 1e8;
+SignalProcessor::SignalProcessor(const SignalProcessorSettings_t &settings)
+{
+    setSettings(settings);
+}
 
-constexpr auto RANGE_SPECTRUM_DT = 1 / RADAR_SAMPLING_FREQUENCY;
-constexpr auto RANGE_SPECTRUM_T_FFT = RANGE_SPECTRUM_DT * SIGNAL_ZERO_PADDED_SIZE;
-constexpr auto RANGE_SPECTRUM_DF = 1 / RANGE_SPECTRUM_T_FFT;
+void SignalProcessor::setSettings(const SignalProcessorSettings_t &settings)
+{
+    m_settings = settings;
 
-SignalProcessor::SignalProcessor()
+    if (!isValidZeroPaddingFactor(m_settings.zero_padding_factor))
+    {
+        qWarning() << "Invalid zero padding factor" << m_settings.zero_padding_factor << ", using" << SIGNAL_DEFAULT_ZERO_PADDING_FACTOR;
+        m_settings.zero_padding_factor = SIGNAL_DEFAULT_ZERO_PADDING_FACTOR;
+    }
+
+    m_window = generateWindow(m_settings.window);
+    m_range_vec = generateRangeVector(m_settings.zero_padding_factor);
+}
+
+const SignalProcessorSettings_t &SignalProcessor::settings() const
 {
-    initialize();
-    generateHannWindow();
-    generateRangeVector();
+    return m_settings;
 }
 
 DataPoints_t SignalProcessor::calculateRangeData(const DataPoints_t &re, const DataPoints_t &im)
 {
-    initialize();
+    m_re_samples.clear();
+    m_im_samples.clear();
+
+    if (re.size() == im.size())
+    {
+        for (auto i = 0; i < re.size(); i++)
+        {
+            m_re_samples.push_back(re[i].y());
+            m_im_samples.push_back(im[i].y());
+        }
+    }
+
+    return calculateRangeData(m_re_samples.data(), m_im_samples.data(), m_re_samples.size());
+}
+
+DataPoints_t SignalProcessor::calculateRangeData(const float *re, const float *im, size_t size)
+{
+    TraceScope trace("calculateRangeData");
     DataPoints_t res;
 
-    if (re.size() > 0 && re.size() == im.size())
+    if (size >= SIGNAL_SAMPLE_SIZE)
+    {
+        windowSignal(re, im, m_window, m_complex_vec);
+        calculateSpectrum(m_complex_vec, m_settings.zero_padding_factor, m_spectrum);
+    }
+    else
     {
-        setMeanValuesOfSignal(re, im);
-        generateComplexSignal(re, im);
-        windowComplexSignal();
-        calculateFft();
+        m_spectrum.assign(m_range_vec.size(), 0.0);
     }
 
-    for (size_t i = 0; i < SIGNAL_SIZE_DISCARD_HALF; i++)
+    for (size_t i = 0; i < m_range_vec.size(); i++)
     {
-        QPointF p(m_range_vec[i], std::abs(m_complex_vec[i]));
+        QPointF p(m_range_vec[i], m_spectrum[i]);
         res.push_back(p);
     }
 
     return res;
 }
 
-void SignalProcessor::setMeanValuesOfSignal(const DataPoints_t &re, const DataPoints_t &im)
+DataPoints_t SignalProcessor::calculateMaxima(const DataPoints_t &range, double &max_y)
 {
-    double re_sum = 0.0;
-    double im_sum = 0.0;
+    m_magnitudes.clear();
+    m_spectrum.clear();
 
-    for (size_t i = 0; i < SIGNAL_SAMPLE_SIZE; i++)
+    for (auto i = 0; i < range.size(); i++)
+    {
+        m_magnitudes.push_back(range[i].y());
+        m_spectrum.push_back(range[i].y());
+    }
+
+    {
+        TraceScope trace("RunPersistence");
+        m_persistence.RunPersistence(m_magnitudes);
+    }
+
+    std::vector<p1d::TPairedExtrema> extrema;
+    m_persistence.GetPairedExtrema(extrema, m_settings.persistence_threshold);
+
+    max_y = 0.0;
+    DataPoints_t maxima;
+
+    for(auto it = extrema.begin(); it != extrema.end(); it++)
     {
-        re_sum += re[i].y();
-        im_sum += im[i].y();
+        if (!passesCfar(m_spectrum, (*it).MaxIndex, m_settings.cfar_guard_cells, m_settings.cfar_training_cells, m_settings.cfar_threshold_factor))
+            continue;
+
+        auto x = range[(*it).MaxIndex].x();
+        auto y = range[(*it).MaxIndex].y();
+
+        maxima.append(QPointF(x, y));
+
+        if (y > max_y)
+            max_y = y;
     }
 
-    m_re_mean = re_sum / SIGNAL_SAMPLE_SIZE;
-    m_im_mean = im_sum / SIGNAL_SAMPLE_SIZE;
+    return maxima;
+}
+
+const DoubleVec_t &SignalProcessor::rangeVector() const
+{
+    return m_range_vec;
 }
 
-void SignalProcessor::generateComplexSignal(const DataPoints_t &re, const DataPoints_t &im)
+size_t SignalProcessor::sampleSize()
 {
+    return SIGNAL_SAMPLE_SIZE;
+}
+
+DoubleVec_t SignalProcessor::generateWindow(WindowType_t type)
+{
+    DoubleVec_t window;
+
     for (auto i = 0; i < SIGNAL_SAMPLE_SIZE; i++)
     {
-        double real = re[i].y() - m_re_mean;
-        double imag = im[i].y() - m_im_mean;
+        double x = 2 * M_PI * i / (SIGNAL_SAMPLE_SIZE - 1);
 
-        Complex_t c(real, imag);
-        m_complex_vec.push_back(c);
+        switch (type)
+        {
+            case WindowType_t::Rectangular:
+                window.push_back(1.0);
+                break;
+            case WindowType_t::Hann:
+                window.push_back(0.5 * (1 - cos(x)));
+                break;
+            case WindowType_t::Hamming:
+                window.push_back(0.54 - 0.46 * cos(x));
+                break;
+            case WindowType_t::Blackman:
+                window.push_back(0.42 - 0.5 * cos(x) + 0.08 * cos(2 * x));
+                break;
+        }
     }
+
+    return window;
 }
 
-void SignalProcessor::generateHannWindow()
+DoubleVec_t SignalProcessor::generateRangeVector(uint32_t zero_padding_factor)
 {
-    for (auto i = 0; i < SIGNAL_WINDOW_SIZE; i++)
+    DoubleVec_t range;
+
+    // Only the first half of the spectrum is kept
+    size_t padded_size = SIGNAL_SAMPLE_SIZE * zero_padding_factor;
+    auto df = RADAR_SAMPLING_FREQUENCY / padded_size;
+
+    for (size_t i = 0; i < padded_size / 2; i++)
     {
-        double val = 0.5 * (1 - cos(2 * M_PI * i/(SIGNAL_WINDOW_SIZE-1)));
-        m_window.push_back(val);
+        auto val = i * df * RADAR_RAMP_TIME_EFF * SPEED_OF_LIGHT / (2 * RADAR_BANDWITH_EFF);
+        range.push_back(QString::number(val, 'f', 2).toDouble());
     }
+
+    return range;
 }
 
-void SignalProcessor::generateRangeVector()
+void SignalProcessor::windowSignal(const float *re, const float *im, const DoubleVec_t &window, ComplexVec_t &windowed)
 {
-    for (auto i = 0.0; i <= (RADAR_SAMPLING_FREQUENCY/2 - RANGE_SPECTRUM_DF); i+=RANGE_SPECTRUM_DF)
+    double re_sum = 0.0;
+    double im_sum = 0.0;
+
+    for (size_t i = 0; i < SIGNAL_SAMPLE_SIZE; i++)
     {
-        auto val = i * RADAR_RAMP_TIME_EFF * SPEED_OF_LIGHT / (2 * RADAR_BANDWITH_EFF);
-        m_range_vec.push_back(QString::number(val, 'f', 2).toDouble());
+        re_sum += re[i];
+        im_sum += im[i];
+    }
+
+    auto re_mean = re_sum / SIGNAL_SAMPLE_SIZE;
+    auto im_mean = im_sum / SIGNAL_SAMPLE_SIZE;
+
+    windowed.clear();
+
+    for (auto i = 0; i < SIGNAL_SAMPLE_SIZE; i++)
+    {
+        Complex_t c(re[i] - re_mean, im[i] - im_mean);
+        windowed.push_back(c * window[i]);
     }
 }
 
-void SignalProcessor::initialize()
+void SignalProcessor::calculateSpectrum(const ComplexVec_t &windowed, uint32_t zero_padding_factor, DoubleVec_t &magnitudes)
 {
-    m_re_mean = 0.0;
-    m_im_mean = 0.0;
-    m_complex_vec.clear();
+    ComplexVec_t padded(windowed);
+    padded.resize(SIGNAL_SAMPLE_SIZE * zero_padding_factor, Complex_t(0, 0));
+
+    auto spectrum = dj::fft1d(padded, dj::fft_dir::DIR_BWD);
+
+    magnitudes.clear();
+
+    for (size_t i = 0; i < spectrum.size() / 2; i++)
+        magnitudes.push_back(std::abs(spectrum[i]));
 }
 
-void SignalProcessor::windowComplexSignal()
+bool SignalProcessor::passesCfar(const DoubleVec_t &magnitudes, size_t index, uint32_t guard_cells, uint32_t training_cells, double threshold_factor)
 {
-    ComplexVec_t res;
+    if (training_cells == 0)
+        return true;
 
-    for (auto i = 0; i < SIGNAL_SAMPLE_SIZE; i++)
+    // Cell averaging over the training cells on both sides, cells beyond the spectrum borders are left out
+    auto sum = 0.0;
+    auto count = 0;
+
+    for (size_t offset = guard_cells + 1; offset <= guard_cells + training_cells; offset++)
     {
-        res.push_back(m_complex_vec[i] * m_window[i]);
+        if (index >= offset)
+        {
+            sum += magnitudes[index - offset];
+            count++;
+        }
+        if (index + offset < magnitudes.size())
+        {
+            sum += magnitudes[index + offset];
+            count++;
+        }
     }
 
-    m_complex_vec = res;
+    if (count == 0)
+        return true;
+
+    return magnitudes[index] > threshold_factor * sum / count;
+}
+
+bool SignalProcessor::isValidZeroPaddingFactor(uint32_t zero_padding_factor)
+{
+    return zero_padding_factor > 0 && (zero_padding_factor & (zero_padding_factor - 1)) == 0;
+}
+
+bool SignalProcessor::windowFromName(const QString &name, WindowType_t &window)
+{
+    auto lower = name.toLower();
+
+    if (lower == "rectangular")
+        window = WindowType_t::Rectangular;
+    else if (lower == "hann")
+        window = WindowType_t::Hann;
+    else if (lower == "hamming")
+        window = WindowType_t::Hamming;
+    else if (lower == "blackman")
+        window = WindowType_t::Blackman;
+    else
+        return false;
+
+    return true;
 }
 
-void SignalProcessor::calculateFft()
+QString SignalProcessor::windowName(WindowType_t window)
 {
-    for (auto i = 0; i < SIGNAL_ZEROES_AMOUNT; i++)
+    switch (window)
     {
-        Complex_t c (0,0);
-        m_complex_vec.push_back(c);
+        case WindowType_t::Rectangular:
+            return "Rectangular";
+        case WindowType_t::Hann:
+            return "Hann";
+        case WindowType_t::Hamming:
+            return "Hamming";
+        case WindowType_t::Blackman:
+            return "Blackman";
     }
 
-    m_complex_vec = dj::fft1d(m_complex_vec, dj::fft_dir::DIR_BWD);
+    return QString();
 }
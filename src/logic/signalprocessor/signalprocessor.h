@@ -2,29 +2,64 @@
 #define SIGNALPROCESSOR_H
 
 #include <misc/types.h>
+#include <misc/constants.h>
 
+#include <persistence1d.hpp>
+#include <QString>
+
+
+enum class WindowType_t
+{
+    Rectangular,
+    Hann,
+    Hamming,
+    Blackman
+};
+
+struct SignalProcessorSettings_t
+{
+    WindowType_t window = WindowType_t::Hann;
+    uint32_t zero_padding_factor = SIGNAL_DEFAULT_ZERO_PADDING_FACTOR;  // Power of two
+    double persistence_threshold = SIGNAL_DEFAULT_PERSISTENCE_THRESHOLD;
+    uint32_t cfar_guard_cells = 0;
+    uint32_t cfar_training_cells = 0;  // Per side, 0 disables the CFAR check of the maxima
+    double cfar_threshold_factor = SIGNAL_DEFAULT_CFAR_THRESHOLD_FACTOR;
+};
 
 class SignalProcessor
 {
 public:
-    SignalProcessor();
+    SignalProcessor(SignalProcessorSettings_t const & settings = SignalProcessorSettings_t());
+    void setSettings(SignalProcessorSettings_t const & settings);
+    SignalProcessorSettings_t const & settings() const;
+
     DataPoints_t calculateRangeData(DataPoints_t const & re, DataPoints_t const & im);
+    DataPoints_t calculateRangeData(float const * re, float const * im, size_t size);
+    DataPoints_t calculateMaxima(DataPoints_t const & range, double & max_y);
+    DoubleVec_t const & rangeVector() const;
 
-private:
-    void initialize();
-    void setMeanValuesOfSignal(DataPoints_t const & re, DataPoints_t const & im);
-    void generateComplexSignal(DataPoints_t const & re, DataPoints_t const & im);
-    void generateHannWindow();
-    void generateRangeVector();
-    void windowComplexSignal();
-    void calculateFft();
+    // Single processing stages, so callers evaluating several settings can share intermediate results
+    static size_t sampleSize();
+    static DoubleVec_t generateWindow(WindowType_t type);
+    static DoubleVec_t generateRangeVector(uint32_t zero_padding_factor);
+    static void windowSignal(float const * re, float const * im, DoubleVec_t const & window, ComplexVec_t & windowed);
+    static void calculateSpectrum(ComplexVec_t const & windowed, uint32_t zero_padding_factor, DoubleVec_t & magnitudes);
+    static bool passesCfar(DoubleVec_t const & magnitudes, size_t index, uint32_t guard_cells, uint32_t training_cells, double threshold_factor);
+
+    static bool isValidZeroPaddingFactor(uint32_t zero_padding_factor);
+    static bool windowFromName(QString const & name, WindowType_t & window);
+    static QString windowName(WindowType_t window);
 
 private:
-    double m_re_mean;
-    double m_im_mean;
+    SignalProcessorSettings_t m_settings;
     DoubleVec_t m_window;
     DoubleVec_t m_range_vec;
     ComplexVec_t m_complex_vec;
+    DoubleVec_t m_spectrum;
+    std::vector<float> m_re_samples;
+    std::vector<float> m_im_samples;
+    std::vector<float> m_magnitudes;
+    p1d::Persistence1D m_persistence;
 };
 
 #endif // SIGNALPROCESSOR_H
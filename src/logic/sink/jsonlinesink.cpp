@@ -0,0 +1,112 @@
+#include "jsonlinesink.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+// Constants
+constexpr auto JSON_LINE_SINK_STDOUT = "-";
+
+JsonLineSink::JsonLineSink(QObject *parent) : QObject(parent)
+{
+    m_stdout = false;
+}
+
+JsonLineSink::~JsonLineSink()
+{
+    close();
+}
+
+bool JsonLineSink::open(const QString &path)
+{
+    m_stdout = isStdoutPath(path);
+
+    if (!m_stdout)
+        m_file.setFileName(path);
+
+    auto opened = m_stdout ? m_file.open(stdout, QIODevice::WriteOnly) : m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+    if (!opened)
+    {
+        qWarning() << "Error while opening sink:" << path;
+        return false;
+    }
+
+    return true;
+}
+
+void JsonLineSink::close()
+{
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+bool JsonLineSink::isStdout() const
+{
+    return m_stdout;
+}
+
+bool JsonLineSink::isStdoutPath(const QString &path)
+{
+    return path == JSON_LINE_SINK_STDOUT;
+}
+
+void JsonLineSink::updateConnection(bool connected)
+{
+    QJsonObject object;
+    object["type"] = "connection";
+    object["connected"] = connected;
+    write(object);
+}
+
+void JsonLineSink::updateRangeData(const DataPoints_t &, const DataPoints_t &, const DataPoints_t &maxima, const double &max_y, qint64 timestamp_ns)
+{
+    QJsonArray array;
+    for (auto const & p : maxima)
+    {
+        QJsonObject maximum;
+        maximum["range"] = p.x();
+        maximum["magnitude"] = p.y();
+        array.append(maximum);
+    }
+
+    QJsonObject object;
+    object["type"] = "maxima";
+    object["timestamp_ns"] = timestamp_ns;
+    object["max"] = max_y;
+    object["maxima"] = array;
+    write(object);
+}
+
+void JsonLineSink::updateTargetData(const Targets_t &targets, qint64 timestamp_ns)
+{
+    QJsonArray array;
+    for (auto const & t : targets)
+    {
+        QJsonObject target;
+        target["id"] = static_cast<qint64>(t.target_id);
+        target["level"] = t.level;
+        target["radius"] = t.radius;
+        target["azimuth"] = t.azimuth;
+        target["elevation"] = t.elevation;
+        target["radial_speed"] = t.radial_speed;
+        target["azimuth_speed"] = t.azimuth_speed;
+        target["elevation_speed"] = t.elevation_speed;
+        array.append(target);
+    }
+
+    QJsonObject object;
+    object["type"] = "targets";
+    object["timestamp_ns"] = timestamp_ns;
+    object["targets"] = array;
+    write(object);
+}
+
+void JsonLineSink::write(const QJsonObject &object)
+{
+    if (!m_file.isOpen())
+        return;
+
+    m_file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+    m_file.write("\n");
+    m_file.flush();
+}
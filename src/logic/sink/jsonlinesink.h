@@ -0,0 +1,38 @@
+#ifndef JSONLINESINK_H
+#define JSONLINESINK_H
+
+#include <misc/types.h>
+
+#include <QObject>
+#include <QFile>
+#include <QJsonObject>
+
+// Writes connection changes, range maxima and targets as one JSON object per line
+class JsonLineSink : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit JsonLineSink(QObject *parent = nullptr);
+    ~JsonLineSink();
+
+    bool open(QString const & path);
+    void close();
+    bool isStdout() const;
+
+    static bool isStdoutPath(QString const & path);
+
+public slots:
+    void updateConnection(bool connected);
+    void updateRangeData(DataPoints_t const & rx1, DataPoints_t const & rx2, DataPoints_t const & maxima, double const & max_y, qint64 timestamp_ns);
+    void updateTargetData(Targets_t const & targets, qint64 timestamp_ns);
+
+private:
+    void write(QJsonObject const & object);
+
+private:
+    QFile m_file;
+    bool m_stdout;
+};
+
+#endif // JSONLINESINK_H
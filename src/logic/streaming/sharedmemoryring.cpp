@@ -0,0 +1,369 @@
+#include "sharedmemoryring.h"
+
+#include <QDebug>
+#include <cstring>
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <signal.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// Constants
+constexpr auto SHARED_MEMORY_RING_DROP_LOG_INTERVAL = 100;
+
+static uint32_t roundUpToPowerOfTwo(uint32_t value)
+{
+    uint32_t result = 1;
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+
+#ifdef __linux__
+// Process id of the writer of an existing ring if it is still running, 0 for a stale or foreign object
+static pid_t liveWriter(char const * name)
+{
+    auto fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return 0;
+
+    struct stat st;
+    auto data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(SharedMemoryRingHeader_t))
+        data = mmap(nullptr, sizeof(SharedMemoryRingHeader_t), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (data == MAP_FAILED)
+        return 0;
+
+    auto header = static_cast<SharedMemoryRingHeader_t const*>(data);
+    auto valid = memcmp(header->magic, SHARED_MEMORY_RING_MAGIC, sizeof(header->magic)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    pid_t pid = valid ? header->writer_pid : 0;
+    munmap(data, sizeof(SharedMemoryRingHeader_t));
+
+    // The signal isn't sent, only the existence of the process is checked
+    if (pid <= 0 || pid == getpid() || (kill(pid, 0) != 0 && errno != EPERM))
+        return 0;
+
+    return pid;
+}
+#endif
+
+SharedMemoryRing::SharedMemoryRing()
+{
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_slot = nullptr;
+    m_write_index = 0;
+    m_messages_dropped = 0;
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+    close();
+}
+
+bool SharedMemoryRing::open(const SharedMemoryRingSettings_t &settings)
+{
+#ifdef __linux__
+    auto slot_count = roundUpToPowerOfTwo(qMax<quint32>(settings.slot_count, 2));
+    auto slot_stride = (sizeof(SharedMemoryRingSlot_t) + settings.slot_size + SHARED_MEMORY_RING_ALIGNMENT - 1) / SHARED_MEMORY_RING_ALIGNMENT * SHARED_MEMORY_RING_ALIGNMENT;
+
+    m_name = settings.name;
+    m_size = sizeof(SharedMemoryRingHeader_t) + slot_count * slot_stride;
+
+    // Always start with a fresh object. One left behind by a crashed writer is replaced, readers still
+    // mapping it keep it until they unmap. The ring of a running writer is never taken over.
+    auto name = m_name.toLocal8Bit();
+    auto fd = shm_open(name.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST)
+    {
+        auto pid = liveWriter(name.constData());
+        if (pid != 0)
+        {
+            qWarning() << "Shared memory" << m_name << "is already published by process" << pid;
+            return false;
+        }
+
+        qInfo() << "Replacing stale shared memory" << m_name;
+        shm_unlink(name.constData());
+        fd = shm_open(name.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+
+    if (fd < 0)
+    {
+        qWarning() << "Error while creating shared memory:" << strerror(errno);
+        return false;
+    }
+
+    if (ftruncate(fd, m_size) != 0)
+    {
+        qWarning() << "Error while sizing shared memory:" << strerror(errno);
+        ::close(fd);
+        shm_unlink(name.constData());
+        return false;
+    }
+
+    auto data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        qWarning() << "Error while mapping shared memory:" << strerror(errno);
+        shm_unlink(name.constData());
+        return false;
+    }
+
+    // The object is zero filled, so all slot sequences and the write index start at 0.
+    // The magic is written last, readers don't attach before.
+    m_data = static_cast<uint8_t*>(data);
+    m_header = reinterpret_cast<SharedMemoryRingHeader_t*>(m_data);
+    m_header->version = SHARED_MEMORY_RING_VERSION;
+    m_header->slot_count = slot_count;
+    m_header->slot_stride = slot_stride;
+    m_header->max_payload_size = slot_stride - sizeof(SharedMemoryRingSlot_t);
+    m_header->writer_pid = getpid();
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(m_header->magic, SHARED_MEMORY_RING_MAGIC, sizeof(m_header->magic));
+
+    m_write_index = 0;
+    m_messages_dropped = 0;
+
+    qInfo() << "Publishing to shared memory" << m_name << "with" << slot_count << "slots of" << m_header->max_payload_size << "bytes";
+    return true;
+#else
+    Q_UNUSED(settings)
+    qWarning() << "Shared memory publication is only supported on linux.";
+    return false;
+#endif
+}
+
+void SharedMemoryRing::close()
+{
+#ifdef __linux__
+    if (m_data == nullptr)
+        return;
+
+    munmap(m_data, m_size);
+    shm_unlink(m_name.toLocal8Bit().constData());
+
+    qInfo() << "Shared memory closed:" << m_write_index << "messages published," << m_messages_dropped << "dropped.";
+#endif
+
+    m_data = nullptr;
+    m_header = nullptr;
+}
+
+bool SharedMemoryRing::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+void SharedMemoryRing::publishFrame(const Frame_Info_t &frame_info, qint64 timestamp_ns)
+{
+    auto out = beginMessage(STREAM_TOPIC_FRAMES, timestamp_ns, framePayloadSize(frame_info));
+    if (out == nullptr)
+        return;
+
+    writeFramePayload(frame_info, out);
+    commitMessage();
+}
+
+void SharedMemoryRing::publishRangeData(const DataPoints_t &rx1, const DataPoints_t &rx2, qint64 timestamp_ns)
+{
+    auto out = beginMessage(STREAM_TOPIC_RANGE_DATA, timestamp_ns, rangeDataPayloadSize(rx1));
+    if (out == nullptr)
+        return;
+
+    writeRangeDataPayload(rx1, rx2, out);
+    commitMessage();
+}
+
+void SharedMemoryRing::publishMaxima(const DataPoints_t &maxima, double max_y, qint64 timestamp_ns)
+{
+    auto out = beginMessage(STREAM_TOPIC_MAXIMA, timestamp_ns, maximaPayloadSize(maxima));
+    if (out == nullptr)
+        return;
+
+    writeMaximaPayload(maxima, max_y, out);
+    commitMessage();
+}
+
+void SharedMemoryRing::publishTargets(const Targets_t &targets, qint64 timestamp_ns)
+{
+    auto out = beginMessage(STREAM_TOPIC_TARGETS, timestamp_ns, targetsPayloadSize(targets));
+    if (out == nullptr)
+        return;
+
+    writeTargetsPayload(targets, out);
+    commitMessage();
+}
+
+uint8_t *SharedMemoryRing::beginMessage(uint32_t type, qint64 timestamp_ns, uint32_t payload_size)
+{
+    if (m_data == nullptr)
+        return nullptr;
+
+    if (payload_size > m_header->max_payload_size)
+    {
+        if (m_messages_dropped++ % SHARED_MEMORY_RING_DROP_LOG_INTERVAL == 0)
+            qWarning() << "Message of" << payload_size << "bytes exceeds the shared memory slot size," << m_messages_dropped << "dropped.";
+        return nullptr;
+    }
+
+    auto index = m_write_index & (m_header->slot_count - 1);
+    m_slot = reinterpret_cast<SharedMemoryRingSlot_t*>(m_data + sizeof(SharedMemoryRingHeader_t) + index * m_header->slot_stride);
+
+    // Odd sequence: readers of this slot will discard what they copy from now on
+    m_slot->sequence.store(2 * m_write_index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_slot->header.size = payload_size;
+    m_slot->header.type = type;
+    m_slot->header.timestamp_ns = timestamp_ns;
+
+    return reinterpret_cast<uint8_t*>(m_slot) + sizeof(SharedMemoryRingSlot_t);
+}
+
+void SharedMemoryRing::commitMessage()
+{
+    m_slot->sequence.store(2 * m_write_index + 2, std::memory_order_release);
+    m_write_index++;
+    m_header->write_index.store(m_write_index, std::memory_order_release);
+}
+
+SharedMemoryRingReader::SharedMemoryRingReader()
+{
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_read_index = 0;
+    m_messages_lost = 0;
+}
+
+SharedMemoryRingReader::~SharedMemoryRingReader()
+{
+    close();
+}
+
+bool SharedMemoryRingReader::open(const QString &name)
+{
+#ifdef __linux__
+    auto fd = shm_open(name.toLocal8Bit().constData(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+        qWarning() << "Error while opening shared memory:" << strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SharedMemoryRingHeader_t))
+    {
+        qWarning() << "Shared memory is too small.";
+        ::close(fd);
+        return false;
+    }
+
+    auto data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        qWarning() << "Error while mapping shared memory:" << strerror(errno);
+        return false;
+    }
+
+    m_data = static_cast<uint8_t const*>(data);
+    m_size = st.st_size;
+    m_header = reinterpret_cast<SharedMemoryRingHeader_t const*>(m_data);
+
+    auto valid = memcmp(m_header->magic, SHARED_MEMORY_RING_MAGIC, sizeof(m_header->magic)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (!valid || m_header->version != SHARED_MEMORY_RING_VERSION ||
+        sizeof(SharedMemoryRingHeader_t) + static_cast<size_t>(m_header->slot_count) * m_header->slot_stride > m_size)
+    {
+        qWarning() << "Shared memory doesn't contain a valid ring.";
+        close();
+        return false;
+    }
+
+    // Only messages published from now on are read
+    m_read_index = m_header->write_index.load(std::memory_order_acquire);
+    m_messages_lost = 0;
+    return true;
+#else
+    Q_UNUSED(name)
+    qWarning() << "Shared memory publication is only supported on linux.";
+    return false;
+#endif
+}
+
+void SharedMemoryRingReader::close()
+{
+#ifdef __linux__
+    if (m_data != nullptr)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_header = nullptr;
+}
+
+bool SharedMemoryRingReader::read(StreamMessageHeader_t &header, std::vector<uint8_t> &payload)
+{
+    if (m_header == nullptr)
+        return false;
+
+    for (;;)
+    {
+        auto write_index = m_header->write_index.load(std::memory_order_acquire);
+        if (m_read_index >= write_index)
+            return false;
+
+        // Lapped by the writer: skip to the oldest message that can still be intact
+        if (write_index - m_read_index > m_header->slot_count)
+        {
+            m_messages_lost += write_index - m_header->slot_count - m_read_index;
+            m_read_index = write_index - m_header->slot_count;
+        }
+
+        auto slot = slotAt(m_read_index);
+        auto expected = 2 * m_read_index + 2;
+
+        auto before = slot->sequence.load(std::memory_order_acquire);
+        if (before == expected)
+        {
+            header = slot->header;
+            auto size = qMin(header.size, m_header->max_payload_size);
+            payload.resize(size);
+            memcpy(payload.data(), reinterpret_cast<uint8_t const*>(slot) + sizeof(SharedMemoryRingSlot_t), size);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->sequence.load(std::memory_order_relaxed) == expected)
+            {
+                m_read_index++;
+                return true;
+            }
+        }
+
+        // Overwritten while or before copying
+        m_messages_lost++;
+        m_read_index++;
+    }
+}
+
+quint64 SharedMemoryRingReader::messagesLost() const
+{
+    return m_messages_lost;
+}
+
+SharedMemoryRingSlot_t const *SharedMemoryRingReader::slotAt(uint64_t index) const
+{
+    auto offset = sizeof(SharedMemoryRingHeader_t) + (index & (m_header->slot_count - 1)) * m_header->slot_stride;
+    return reinterpret_cast<SharedMemoryRingSlot_t const*>(m_data + offset);
+}
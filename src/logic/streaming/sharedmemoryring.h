@@ -0,0 +1,110 @@
+#ifndef SHAREDMEMORYRING_H
+#define SHAREDMEMORYRING_H
+
+#include <misc/types.h>
+#include <logic/streaming/streamprotocol.h>
+
+#include <EndpointRadarBase.h>
+#include <QString>
+#include <atomic>
+#include <vector>
+
+// Layout of the shared memory object:
+//
+//   SharedMemoryRingHeader_t, followed by slot_count slots of slot_stride bytes each.
+//   Every slot starts with a SharedMemoryRingSlot_t, followed by the payload of the message as described
+//   in streamprotocol.h. Message n of the ring is stored in slot n % slot_count.
+//
+// Slots are versioned like a seqlock: while message n is written, the sequence of its slot is 2n + 1,
+// afterwards 2n + 2. Readers copy a slot and check that its sequence didn't change meanwhile; a different
+// sequence means the writer lapped them and the message is lost. The writer never waits for readers.
+
+constexpr char SHARED_MEMORY_RING_MAGIC[8] = {'P', '2', 'G', 'S', 'H', 'M', '0', '1'};
+constexpr uint32_t SHARED_MEMORY_RING_VERSION = 1;
+constexpr uint32_t SHARED_MEMORY_RING_ALIGNMENT = 64;
+
+struct SharedMemoryRingHeader_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_count;                // Power of two
+    uint32_t slot_stride;               // Bytes from one slot to the next
+    uint32_t max_payload_size;
+    std::atomic<uint64_t> write_index;  // Number of completely written messages
+    uint32_t writer_pid;                // Process publishing into the ring, a second writer doesn't take it over
+    uint8_t reserved[28];
+};
+
+struct SharedMemoryRingSlot_t
+{
+    std::atomic<uint64_t> sequence;
+    StreamMessageHeader_t header;
+    uint8_t reserved[40];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory ring requires lock free 64 bit atomics");
+static_assert(sizeof(SharedMemoryRingHeader_t) == SHARED_MEMORY_RING_ALIGNMENT, "Unexpected shared memory ring header size");
+static_assert(sizeof(SharedMemoryRingSlot_t) == SHARED_MEMORY_RING_ALIGNMENT, "Unexpected shared memory ring slot size");
+
+struct SharedMemoryRingSettings_t
+{
+    QString name;           // POSIX shared memory object name, e.g. /p2g-dashboard
+    quint32 slot_count;     // Rounded up to a power of two
+    quint32 slot_size;      // Maximum payload per message in bytes
+};
+
+// Single writer, called from the acquisition thread
+class SharedMemoryRing
+{
+public:
+    SharedMemoryRing();
+    ~SharedMemoryRing();
+
+    bool open(SharedMemoryRingSettings_t const & settings);
+    void close();
+    bool isOpen() const;
+
+    void publishFrame(Frame_Info_t const & frame_info, qint64 timestamp_ns);
+    void publishRangeData(DataPoints_t const & rx1, DataPoints_t const & rx2, qint64 timestamp_ns);
+    void publishMaxima(DataPoints_t const & maxima, double max_y, qint64 timestamp_ns);
+    void publishTargets(Targets_t const & targets, qint64 timestamp_ns);
+
+private:
+    uint8_t * beginMessage(uint32_t type, qint64 timestamp_ns, uint32_t payload_size);
+    void commitMessage();
+
+private:
+    QString m_name;
+    uint8_t *m_data;
+    size_t m_size;
+    SharedMemoryRingHeader_t *m_header;
+    SharedMemoryRingSlot_t *m_slot;
+    uint64_t m_write_index;
+    quint64 m_messages_dropped;
+};
+
+// Polls the ring of another process without any system call
+class SharedMemoryRingReader
+{
+public:
+    SharedMemoryRingReader();
+    ~SharedMemoryRingReader();
+
+    bool open(QString const & name);
+    void close();
+
+    bool read(StreamMessageHeader_t & header, std::vector<uint8_t> & payload);
+    quint64 messagesLost() const;
+
+private:
+    SharedMemoryRingSlot_t const * slotAt(uint64_t index) const;
+
+private:
+    uint8_t const *m_data;
+    size_t m_size;
+    SharedMemoryRingHeader_t const *m_header;
+    uint64_t m_read_index;
+    quint64 m_messages_lost;
+};
+
+#endif // SHAREDMEMORYRING_H
@@ -0,0 +1,87 @@
+#include "streamprotocol.h"
+
+#include <logic/recording/recordingformat.h>
+
+#include <cstring>
+
+uint32_t framePayloadSize(const Frame_Info_t &frame_info)
+{
+    return sizeof(StreamFrame_t) + totalSampleCount(frame_info) * sizeof(float);
+}
+
+void writeFramePayload(const Frame_Info_t &frame_info, uint8_t *out)
+{
+    StreamFrame_t frame;
+    frame.frame_number = frame_info.frame_number;
+    frame.num_chirps = frame_info.num_chirps;
+    frame.num_samples_per_chirp = frame_info.num_samples_per_chirp;
+    frame.num_rx_antennas = frame_info.num_rx_antennas;
+    frame.rx_mask = frame_info.rx_mask;
+    frame.adc_resolution = frame_info.adc_resolution;
+    frame.interleaved_rx = frame_info.interleaved_rx;
+    frame.data_format = frame_info.data_format;
+    frame.num_samples = totalSampleCount(frame_info);
+    frame.reserved = 0;
+
+    memcpy(out, &frame, sizeof(frame));
+    memcpy(out + sizeof(frame), frame_info.sample_data, frame.num_samples * sizeof(float));
+}
+
+uint32_t rangeDataPayloadSize(const DataPoints_t &rx1)
+{
+    return sizeof(StreamRangeData_t) + 3 * rx1.size() * sizeof(float);
+}
+
+void writeRangeDataPayload(const DataPoints_t &rx1, const DataPoints_t &rx2, uint8_t *out)
+{
+    StreamRangeData_t range_data;
+    range_data.num_bins = rx1.size();
+    range_data.reserved = 0;
+    memcpy(out, &range_data, sizeof(range_data));
+
+    // Columns: range, antenna 1, antenna 2
+    auto num_bins = range_data.num_bins;
+    auto columns = reinterpret_cast<float*>(out + sizeof(range_data));
+    for (uint32_t i = 0; i < num_bins; i++)
+    {
+        columns[i] = rx1[i].x();
+        columns[num_bins + i] = rx1[i].y();
+        columns[2 * num_bins + i] = i < static_cast<uint32_t>(rx2.size()) ? rx2[i].y() : 0.f;
+    }
+}
+
+uint32_t maximaPayloadSize(const DataPoints_t &maxima)
+{
+    return sizeof(StreamMaxima_t) + 2 * maxima.size() * sizeof(float);
+}
+
+void writeMaximaPayload(const DataPoints_t &maxima, double max_y, uint8_t *out)
+{
+    StreamMaxima_t header;
+    header.num_maxima = maxima.size();
+    header.max_magnitude = max_y;
+    memcpy(out, &header, sizeof(header));
+
+    auto pairs = reinterpret_cast<float*>(out + sizeof(header));
+    for (uint32_t i = 0; i < header.num_maxima; i++)
+    {
+        pairs[2 * i] = maxima[i].x();
+        pairs[2 * i + 1] = maxima[i].y();
+    }
+}
+
+uint32_t targetsPayloadSize(const Targets_t &targets)
+{
+    return sizeof(StreamTargets_t) + targets.size() * sizeof(Target_Info_t);
+}
+
+void writeTargetsPayload(const Targets_t &targets, uint8_t *out)
+{
+    StreamTargets_t header;
+    header.num_targets = targets.size();
+    header.reserved = 0;
+    memcpy(out, &header, sizeof(header));
+
+    if (header.num_targets > 0)
+        memcpy(out + sizeof(header), targets.constData(), header.num_targets * sizeof(Target_Info_t));
+}
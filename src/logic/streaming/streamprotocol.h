@@ -0,0 +1,91 @@
+#ifndef STREAMPROTOCOL_H
+#define STREAMPROTOCOL_H
+
+#include <misc/types.h>
+
+#include <EndpointRadarBase.h>
+#include <cstdint>
+
+// Messages sent by the stream server, all fields little endian:
+//
+//   StreamMessageHeader_t, followed by header.size bytes of payload depending on header.type
+//
+//   Hello:      StreamHello_t, sent once after connecting
+//   Frame:      StreamFrame_t, float samples[num_samples] as delivered by the sensor
+//   RangeData:  StreamRangeData_t, float range_m[num_bins], float rx1[num_bins], float rx2[num_bins]
+//   Maxima:     StreamMaxima_t, {float range_m, float magnitude}[num_maxima]
+//   Targets:    StreamTargets_t, Target_Info_t[num_targets]
+//
+// Clients choose their topics by sending a uint32_t bit mask of STREAM_TOPIC_* values at any time,
+// no topics are subscribed after connecting. Messages a client can't keep up with are dropped for that client.
+
+constexpr char STREAM_MAGIC[8] = {'P', '2', 'G', 'S', 'T', 'R', '0', '1'};
+constexpr uint32_t STREAM_VERSION = 1;
+
+constexpr uint32_t STREAM_MESSAGE_HELLO = 0;
+constexpr uint32_t STREAM_TOPIC_FRAMES = 1 << 0;
+constexpr uint32_t STREAM_TOPIC_RANGE_DATA = 1 << 1;
+constexpr uint32_t STREAM_TOPIC_MAXIMA = 1 << 2;
+constexpr uint32_t STREAM_TOPIC_TARGETS = 1 << 3;
+constexpr uint32_t STREAM_TOPICS_ALL = STREAM_TOPIC_FRAMES | STREAM_TOPIC_RANGE_DATA | STREAM_TOPIC_MAXIMA | STREAM_TOPIC_TARGETS;
+
+struct StreamMessageHeader_t
+{
+    uint32_t size;          // Payload bytes following this header
+    uint32_t type;          // STREAM_MESSAGE_HELLO or one of the STREAM_TOPIC_* values
+    int64_t timestamp_ns;   // Monotonic acquisition time of the frame
+};
+
+struct StreamHello_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t topics;        // Topics offered by the server
+};
+
+struct StreamFrame_t
+{
+    uint32_t frame_number;
+    uint32_t num_chirps;
+    uint32_t num_samples_per_chirp;
+    uint32_t num_rx_antennas;
+    uint32_t rx_mask;
+    uint32_t adc_resolution;
+    uint32_t interleaved_rx;
+    uint32_t data_format;
+    uint32_t num_samples;
+    uint32_t reserved;
+};
+
+struct StreamRangeData_t
+{
+    uint32_t num_bins;
+    uint32_t reserved;
+};
+
+struct StreamMaxima_t
+{
+    uint32_t num_maxima;
+    float max_magnitude;
+};
+
+struct StreamTargets_t
+{
+    uint32_t num_targets;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(StreamMessageHeader_t) == 16, "Unexpected stream message header size");
+static_assert(sizeof(StreamFrame_t) == 40, "Unexpected stream frame header size");
+
+// Payload serialization, out has to provide the respective payload size
+uint32_t framePayloadSize(Frame_Info_t const & frame_info);
+void writeFramePayload(Frame_Info_t const & frame_info, uint8_t * out);
+uint32_t rangeDataPayloadSize(DataPoints_t const & rx1);
+void writeRangeDataPayload(DataPoints_t const & rx1, DataPoints_t const & rx2, uint8_t * out);
+uint32_t maximaPayloadSize(DataPoints_t const & maxima);
+void writeMaximaPayload(DataPoints_t const & maxima, double max_y, uint8_t * out);
+uint32_t targetsPayloadSize(Targets_t const & targets);
+void writeTargetsPayload(Targets_t const & targets, uint8_t * out);
+
+#endif // STREAMPROTOCOL_H
@@ -0,0 +1,321 @@
+#include "streamserver.h"
+
+#include <QDebug>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <cstring>
+
+// Constants
+constexpr auto STREAM_DROP_LOG_INTERVAL = 100;
+constexpr auto STREAM_LOCAL_SOCKET_PROBE_TIMEOUT = 100;
+
+StreamServer::StreamServer() : QObject(nullptr)
+{
+    m_local_server = nullptr;
+    m_tcp_server = nullptr;
+    m_owner_thread = nullptr;
+    m_subscriptions = 0;
+    m_client_count = 0;
+    m_messages_dropped = 0;
+    m_pending_bytes = 0;
+    m_queued_bytes = 0;
+    m_messages_rejected = 0;
+    m_thread.setObjectName("StreamServer");
+}
+
+StreamServer::~StreamServer()
+{
+    close();
+}
+
+bool StreamServer::open(const StreamingSettings_t &settings)
+{
+    m_settings = settings;
+
+    // The server objects and sockets live in the server thread
+    m_owner_thread = thread();
+    moveToThread(&m_thread);
+    m_thread.start();
+
+    auto listening = false;
+    QMetaObject::invokeMethod(this, "listen", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, listening));
+
+    if (!listening)
+        close();
+
+    return listening;
+}
+
+void StreamServer::close()
+{
+    if (!m_thread.isRunning())
+        return;
+
+    QMetaObject::invokeMethod(this, "shutdown", Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+bool StreamServer::isSubscribed(uint32_t topic) const
+{
+    return (m_subscriptions.load(std::memory_order_relaxed) & topic) != 0;
+}
+
+StreamServerStatistics_t StreamServer::statistics() const
+{
+    StreamServerStatistics_t s;
+    s.clients = m_client_count;
+    s.messages_dropped = m_messages_dropped;
+    s.pending_bytes = m_pending_bytes;
+    return s;
+}
+
+void StreamServer::publishFrame(const Frame_Info_t &frame_info, qint64 timestamp_ns)
+{
+    if (!isSubscribed(STREAM_TOPIC_FRAMES))
+        return;
+
+    auto message = createMessage(STREAM_TOPIC_FRAMES, timestamp_ns, framePayloadSize(frame_info));
+    writeFramePayload(frame_info, payload(message));
+    publish(STREAM_TOPIC_FRAMES, message);
+}
+
+void StreamServer::publishRangeData(const DataPoints_t &rx1, const DataPoints_t &rx2, qint64 timestamp_ns)
+{
+    if (!isSubscribed(STREAM_TOPIC_RANGE_DATA))
+        return;
+
+    auto message = createMessage(STREAM_TOPIC_RANGE_DATA, timestamp_ns, rangeDataPayloadSize(rx1));
+    writeRangeDataPayload(rx1, rx2, payload(message));
+    publish(STREAM_TOPIC_RANGE_DATA, message);
+}
+
+void StreamServer::publishMaxima(const DataPoints_t &maxima, double max_y, qint64 timestamp_ns)
+{
+    if (!isSubscribed(STREAM_TOPIC_MAXIMA))
+        return;
+
+    auto message = createMessage(STREAM_TOPIC_MAXIMA, timestamp_ns, maximaPayloadSize(maxima));
+    writeMaximaPayload(maxima, max_y, payload(message));
+    publish(STREAM_TOPIC_MAXIMA, message);
+}
+
+void StreamServer::publishTargets(const Targets_t &targets, qint64 timestamp_ns)
+{
+    if (!isSubscribed(STREAM_TOPIC_TARGETS))
+        return;
+
+    auto message = createMessage(STREAM_TOPIC_TARGETS, timestamp_ns, targetsPayloadSize(targets));
+    writeTargetsPayload(targets, payload(message));
+    publish(STREAM_TOPIC_TARGETS, message);
+}
+
+bool StreamServer::listen()
+{
+    if (!m_settings.local_socket.isEmpty())
+    {
+        m_local_server = new QLocalServer(this);
+        m_local_server->setSocketOptions(QLocalServer::UserAccessOption);
+        QObject::connect(m_local_server, &QLocalServer::newConnection, this, &StreamServer::acceptLocalConnection);
+
+        // A socket file left over by a crashed instance would prevent listening, the one of a running
+        // instance still accepts connections and is kept
+        QLocalSocket probe;
+        probe.connectToServer(m_settings.local_socket);
+        if (probe.waitForConnected(STREAM_LOCAL_SOCKET_PROBE_TIMEOUT))
+        {
+            qWarning() << "Local socket" << m_settings.local_socket << "is already used by another instance.";
+            return false;
+        }
+        QLocalServer::removeServer(m_settings.local_socket);
+
+        if (!m_local_server->listen(m_settings.local_socket))
+        {
+            qWarning() << "Error while listening on local socket:" << m_local_server->errorString();
+            return false;
+        }
+        qInfo() << "Streaming on local socket" << m_local_server->fullServerName();
+    }
+
+    if (m_settings.tcp_port != 0)
+    {
+        m_tcp_server = new QTcpServer(this);
+        QObject::connect(m_tcp_server, &QTcpServer::newConnection, this, &StreamServer::acceptTcpConnection);
+
+        if (!m_tcp_server->listen(QHostAddress::LocalHost, m_settings.tcp_port))
+        {
+            qWarning() << "Error while listening on tcp port:" << m_tcp_server->errorString();
+            return false;
+        }
+        qInfo() << "Streaming on tcp port" << m_tcp_server->serverPort();
+    }
+
+    return m_local_server != nullptr || m_tcp_server != nullptr;
+}
+
+void StreamServer::shutdown()
+{
+    for (auto it = m_clients.begin(); it != m_clients.end(); it++)
+    {
+        it.key()->disconnect(this);
+        delete it.key();
+    }
+    m_clients.clear();
+    m_client_count = 0;
+    m_pending_bytes = 0;
+    updateSubscriptions();
+
+    delete m_local_server;
+    delete m_tcp_server;
+    m_local_server = nullptr;
+    m_tcp_server = nullptr;
+
+    // Back to the thread that opened the server, the own one is about to quit
+    moveToThread(m_owner_thread);
+}
+
+void StreamServer::acceptLocalConnection()
+{
+    while (m_local_server->hasPendingConnections())
+    {
+        auto socket = m_local_server->nextPendingConnection();
+        QObject::connect(socket, &QLocalSocket::disconnected, this, [this, socket]() { removeClient(socket); });
+        addClient(socket);
+    }
+}
+
+void StreamServer::acceptTcpConnection()
+{
+    while (m_tcp_server->hasPendingConnections())
+    {
+        auto socket = m_tcp_server->nextPendingConnection();
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        QObject::connect(socket, &QTcpSocket::disconnected, this, [this, socket]() { removeClient(socket); });
+        addClient(socket);
+    }
+}
+
+QByteArray StreamServer::createMessage(uint32_t type, qint64 timestamp_ns, uint32_t payload_size) const
+{
+    QByteArray message(sizeof(StreamMessageHeader_t) + payload_size, Qt::Uninitialized);
+
+    StreamMessageHeader_t header;
+    header.size = payload_size;
+    header.type = type;
+    header.timestamp_ns = timestamp_ns;
+    memcpy(message.data(), &header, sizeof(header));
+
+    return message;
+}
+
+uint8_t *StreamServer::payload(QByteArray &message) const
+{
+    return reinterpret_cast<uint8_t*>(message.data()) + sizeof(StreamMessageHeader_t);
+}
+
+void StreamServer::publish(uint32_t topic, const QByteArray &message)
+{
+    // Messages are serialized by the caller and handed over to the server thread. If that thread falls
+    // behind, messages are dropped here, before they pile up in its event queue.
+    auto size = message.size();
+    if (m_queued_bytes.fetch_add(size, std::memory_order_relaxed) + size > m_settings.max_pending_bytes)
+    {
+        m_queued_bytes.fetch_sub(size, std::memory_order_relaxed);
+        m_messages_dropped++;
+        if (m_messages_rejected++ % STREAM_DROP_LOG_INTERVAL == 0)
+            qWarning() << "Stream server can't keep up:" << m_messages_rejected << "messages dropped.";
+        return;
+    }
+
+    QMetaObject::invokeMethod(this, [this, topic, message]() {
+        m_queued_bytes.fetch_sub(message.size(), std::memory_order_relaxed);
+        broadcast(topic, message);
+    }, Qt::QueuedConnection);
+}
+
+void StreamServer::broadcast(uint32_t topic, const QByteArray &message)
+{
+    qint64 pending_bytes = 0;
+
+    for (auto it = m_clients.begin(); it != m_clients.end(); it++)
+    {
+        auto & client = it.value();
+        auto socket = it.key();
+
+        if ((client.topics & topic) != 0)
+        {
+            if (socket->bytesToWrite() + message.size() > m_settings.max_pending_bytes)
+            {
+                m_messages_dropped++;
+                if (client.messages_dropped++ % STREAM_DROP_LOG_INTERVAL == 0)
+                    qWarning() << "Stream client can't keep up:" << client.messages_dropped << "messages dropped.";
+            }
+            else
+            {
+                socket->write(message);
+            }
+        }
+
+        pending_bytes += socket->bytesToWrite();
+    }
+
+    m_pending_bytes = pending_bytes;
+}
+
+void StreamServer::addClient(QIODevice *socket)
+{
+    m_clients.insert(socket, {0, 0});
+    m_client_count = m_clients.size();
+    QObject::connect(socket, &QIODevice::readyRead, this, [this, socket]() { readSubscription(socket); });
+
+    StreamHello_t hello;
+    memcpy(hello.magic, STREAM_MAGIC, sizeof(hello.magic));
+    hello.version = STREAM_VERSION;
+    hello.topics = STREAM_TOPICS_ALL;
+
+    auto message = createMessage(STREAM_MESSAGE_HELLO, 0, sizeof(hello));
+    memcpy(payload(message), &hello, sizeof(hello));
+    socket->write(message);
+
+    qInfo() << "Stream client connected," << m_clients.size() << "client(s) in total.";
+}
+
+void StreamServer::removeClient(QIODevice *socket)
+{
+    if (!m_clients.contains(socket))
+        return;
+
+    auto client = m_clients.take(socket);
+    m_client_count = m_clients.size();
+    socket->deleteLater();
+    updateSubscriptions();
+
+    qInfo() << "Stream client disconnected," << client.messages_dropped << "messages dropped," << m_clients.size() << "client(s) left.";
+}
+
+void StreamServer::readSubscription(QIODevice *socket)
+{
+    if (!m_clients.contains(socket))
+        return;
+
+    // Only the latest mask counts
+    uint32_t topics;
+    while (socket->bytesAvailable() >= static_cast<qint64>(sizeof(topics)))
+    {
+        socket->read(reinterpret_cast<char*>(&topics), sizeof(topics));
+        m_clients[socket].topics = topics & STREAM_TOPICS_ALL;
+    }
+
+    updateSubscriptions();
+}
+
+void StreamServer::updateSubscriptions()
+{
+    uint32_t subscriptions = 0;
+    for (auto const & client : m_clients)
+        subscriptions |= client.topics;
+
+    m_subscriptions.store(subscriptions, std::memory_order_relaxed);
+}
@@ -0,0 +1,90 @@
+#ifndef STREAMSERVER_H
+#define STREAMSERVER_H
+
+#include <misc/types.h>
+#include <logic/streaming/streamprotocol.h>
+
+#include <EndpointRadarBase.h>
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QThread>
+#include <atomic>
+
+class QIODevice;
+class QLocalServer;
+class QTcpServer;
+
+struct StreamingSettings_t
+{
+    QString local_socket;       // Name or path of the unix domain socket, empty disables it
+    quint16 tcp_port;           // Port on the loopback interface, 0 disables it
+    qint64 max_pending_bytes;   // Unsent bytes per client above which its messages are dropped, also bounds
+                                // the messages waiting for the server thread
+};
+
+struct StreamClient_t
+{
+    uint32_t topics;
+    quint64 messages_dropped;
+};
+
+struct StreamServerStatistics_t
+{
+    quint32 clients;
+    quint64 messages_dropped;
+    qint64 pending_bytes;       // Unsent bytes of all clients
+};
+
+// Publishes pipeline results to local clients. The publish functions can be called from any thread,
+// the sockets are served by an own thread, so slow clients never block the caller.
+class StreamServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    StreamServer();
+    ~StreamServer();
+
+    bool open(StreamingSettings_t const & settings);
+    void close();
+    bool isSubscribed(uint32_t topic) const;
+    StreamServerStatistics_t statistics() const;
+
+    void publishFrame(Frame_Info_t const & frame_info, qint64 timestamp_ns);
+    void publishRangeData(DataPoints_t const & rx1, DataPoints_t const & rx2, qint64 timestamp_ns);
+    void publishMaxima(DataPoints_t const & maxima, double max_y, qint64 timestamp_ns);
+    void publishTargets(Targets_t const & targets, qint64 timestamp_ns);
+
+private slots:
+    bool listen();
+    void shutdown();
+    void acceptLocalConnection();
+    void acceptTcpConnection();
+
+private:
+    QByteArray createMessage(uint32_t type, qint64 timestamp_ns, uint32_t payload_size) const;
+    uint8_t * payload(QByteArray & message) const;
+    void publish(uint32_t topic, QByteArray const & message);
+    void broadcast(uint32_t topic, QByteArray const & message);
+    void addClient(QIODevice *socket);
+    void removeClient(QIODevice *socket);
+    void readSubscription(QIODevice *socket);
+    void updateSubscriptions();
+
+private:
+    QThread m_thread;
+    QThread *m_owner_thread;
+    StreamingSettings_t m_settings;
+    QLocalServer *m_local_server;
+    QTcpServer *m_tcp_server;
+    QHash<QIODevice*, StreamClient_t> m_clients;
+    std::atomic<uint32_t> m_subscriptions;
+    std::atomic<quint32> m_client_count;
+    std::atomic<quint64> m_messages_dropped;
+    std::atomic<qint64> m_pending_bytes;
+    std::atomic<qint64> m_queued_bytes;     // Published, not yet taken by the server thread
+    std::atomic<quint64> m_messages_rejected;
+};
+
+#endif // STREAMSERVER_H
@@ -1,8 +1,18 @@
 #include <misc/types.h>
 #include <misc/constants.h>
 #include <misc/messagehandler.h>
+#include <logic/metrics/latencymetrics.h>
+#include <logic/metrics/metricsserver.h>
+#include <logic/metrics/tracerecorder.h>
 #include <logic/radar/radar.h>
+#include <logic/pipeline/pipeline.h>
+#include <logic/recording/recordingwriter.h>
+#include <logic/framesource/replaysource.h>
+#include <logic/framesource/syntheticsource.h>
 #include <logic/settings/settingsloader.h>
+#include <logic/settings/settingswatcher.h>
+#include <logic/sink/jsonlinesink.h>
+#include <logic/streaming/streamserver.h>
 #include <gui/dashboard/dashboard.h>
 #include <gui/statusbar/statusbar.h>
 #include <gui/toolbar/toolbar.h>
@@ -10,32 +20,40 @@
 #include <gui/chart/timedata/timedatachart.h>
 #include <gui/chart/rangedata/rangedatachart.h>
 #include <gui/chart/targetdata/targetdatachart.h>
+#include <gui/chart/updater/chartupdater.h>
+#include <gui/chart/waterfall/waterfallchart.h>
+#include <gui/timeline/timeline.h>
+#include <logic/history/historyplayer.h>
+#include <logic/history/historyring.h>
 #ifdef __linux__
     #include "sigwatch.h"
 #endif
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QScopedPointer>
+#include <QShortcut>
 #include <QThread>
+#include <QTimer>
 
 
 bool tryConnect(Radar & r)
 {
-    auto attempts = 0;
-    while (attempts <  STARTUP_CONNECTION_ATTEMPS)
+    // The sensor may still be enumerating after a reboot, so it is polled in short intervals. Ports
+    // without USB identifiers are only probed by the last attempt, as each of them costs a timeout.
+    for (auto attempts = 1; attempts <= STARTUP_CONNECTION_ATTEMPS; attempts++)
     {
-        attempts++;
         qInfo() << "Connection attempt" << "(" << attempts << "/" << STARTUP_CONNECTION_ATTEMPS << ")";
-        if (r.connect())
-            break;
+        if (r.connect(attempts == STARTUP_CONNECTION_ATTEMPS))
+            return true;
         QThread::msleep(STARTUP_CONNECTION_PAUSE_TIME);
     }
 
-    if (attempts == STARTUP_CONNECTION_ATTEMPS)
-    {
-        qCritical() << "Aborted: Failed to connect to radar sensor. ";
-        return false;
-    }
-    return true;
+    qCritical() << "Aborted: Failed to connect to radar sensor. ";
+    return false;
 }
 
 bool tryAddingEndpoints(Radar & r)
@@ -72,12 +90,38 @@ bool trySettingUpFrameTrigger(Radar & r)
     return true;
 }
 
-bool tryParsingSettings(Settings_t & s)
+bool tryOpeningReplay(ReplaySource & r, QString const & path, double speed, double start)
+{
+    qInfo() << "Trying to open recording for replay...";
+    if (!r.open(path))
+    {
+        qCritical() << "Error: Failed to open recording. ";
+        return false;
+    }
+    r.setSpeed(speed);
+    r.setStartTime(start);
+    qInfo() << "Successfully opened recording.";
+
+    return true;
+}
+
+FrameSource * createFrameSource(QCommandLineParser const & parser)
+{
+    if (parser.isSet("replay"))
+        return new ReplaySource();
+
+    if (parser.isSet("synthetic"))
+        return new SyntheticSource();
+
+    return new Radar();
+}
+
+bool tryParsingSettings(Settings_t & s, QJsonObject & json)
 {
     SettingsLoader loader;
     qInfo() << "Trying to parse configuration file...";
 
-    if (!loader.parseSettings(CONFIGURATION_FILE_PATH, s))
+    if (!loader.parseSettings(CONFIGURATION_FILE_PATH, s, &json))
     {
         qCritical() << "Error: Failed to parse configuration file.";
         return false;
@@ -87,125 +131,419 @@ bool tryParsingSettings(Settings_t & s)
     return true;
 }
 
+bool tryOpeningSink(JsonLineSink & s, QString const & path)
+{
+    qInfo() << "Trying to open result sink...";
+    if (!s.open(path))
+    {
+        qCritical() << "Error: Failed to open result sink. ";
+        return false;
+    }
+    qInfo() << "Successfully opened result sink.";
 
-int main(int argc, char *argv[])
+    return true;
+}
+
+void logLatencyMetrics()
 {
-    // Register the message handler within the application
-    qInstallMessageHandler(messageHandler);
-    QApplication a(argc, argv);
+    qInfo().noquote() << "Latency per stage:\n" + LatencyMetrics::instance().dump();
+}
 
-    // Signal watch for linux to catch all kinds of termination, so the radar can get into a defined state
-#ifdef __linux__
-    UnixSignalWatcher sigwatch;
-    sigwatch.watchForSignal(SIGINT);
-    sigwatch.watchForSignal(SIGTERM);
-    sigwatch.watchForSignal(SIGQUIT);
-    sigwatch.watchForSignal(SIGHUP);
-    QObject::connect(&sigwatch, SIGNAL(unixSignal(int)), &a, SLOT(quit()));
-#endif
+void dumpTrace(QString const & path)
+{
+    // Every dump gets its own file, numbered like rotated recordings
+    static auto dumps = 0;
+    QFileInfo info(path);
+    auto name = QString("%1_%2.%3").arg(info.completeBaseName()).arg(dumps++, 4, 10, QChar('0')).arg(info.suffix().isEmpty() ? "json" : info.suffix());
+    TraceRecorder::instance().dump(info.dir().filePath(name));
+}
 
-    // Instantiate all variables
-    Settings_t settings;
-    Radar radar;
+bool isHeadless(int argc, char *argv[])
+{
+    for (auto i = 1; i < argc; i++)
+    {
+        if (qstrcmp(argv[i], "--headless") == 0)
+            return true;
+    }
+
+    return false;
+}
+
+// Widgets of the dashboard, only instantiated without --headless
+struct Gui_t
+{
     Dashboard dashboard;
     StatusBar statusbar;
-    ToolBar toolbar(&dashboard);
-    Settings settings_dialog(&dashboard);
+    ToolBar toolbar{&dashboard};
+    Settings settings_dialog{&dashboard};
     TimeDataChart timedata;
     RangeDataChart rangedata;
     TargetDataChart targetdata;
-
-    // Load Settings
-    if (!tryParsingSettings(settings))
-    {
-        return ERROR_STARTUP_PARSING_CONFIGURATION_FAILED;
-    }
-
+    WaterfallChart waterfall;
+    ChartUpdater updater{&timedata, &rangedata, &targetdata};
+    Timeline timeline;
+    HistoryPlayer player;
+    Hud hud;
+};
+
+void setupDashboard(Gui_t & gui, Settings_t const & settings, FrameSource * source, Radar * radar, Pipeline & pipeline, HistoryRing * history)
+{
     // Setup the Mainwindow
     if (settings.statusbar_enabled)
     {
-        dashboard.setStatusbar(&statusbar);
+        gui.dashboard.setStatusbar(&gui.statusbar);
+
+        // Connections: Frame source --> Statusbar
+        QObject::connect(source, &FrameSource::connectionChanged, &gui.statusbar, &StatusBar::updateConnection);
 
         // Connections: Radar --> Statusbar
-        QObject::connect(&radar, &Radar::connectionChanged, &statusbar, &StatusBar::updateConnection);
-        QObject::connect(&radar, &Radar::firmwareInformationChanged, &statusbar, &StatusBar::updateFirmwareInformation);
-        QObject::connect(&radar, &Radar::temperatureChanged, &statusbar, &StatusBar::updateTemperature);
-        QObject::connect(&radar, &Radar::serialPortChanged, &statusbar, &StatusBar::updateSerialPort);
+        if (radar != nullptr)
+        {
+            QObject::connect(radar, &Radar::firmwareInformationChanged, &gui.statusbar, &StatusBar::updateFirmwareInformation);
+            QObject::connect(radar, &Radar::temperatureChanged, &gui.statusbar, &StatusBar::updateTemperature);
+            QObject::connect(radar, &Radar::serialPortChanged, &gui.statusbar, &StatusBar::updateSerialPort);
+            QObject::connect(radar, &Radar::commandExecuted, &gui.statusbar, &StatusBar::updateCommand);
+        }
     }
 
-    if (settings.toolbar_enabled)
+    if (settings.toolbar_enabled && radar != nullptr)
     {
-        dashboard.setToolbar(&toolbar);
-        dashboard.setSettings(&settings_dialog);
+        gui.dashboard.setToolbar(&gui.toolbar);
+        gui.dashboard.setSettings(&gui.settings_dialog);
 
         // Connections: Toolbar --> Settings
-        QObject::connect(&toolbar, &ToolBar::settingsClicked, &settings_dialog, &Settings::requestAll);
-        QObject::connect(&toolbar, &ToolBar::settingsClicked, &settings_dialog, &Settings::show);
+        QObject::connect(&gui.toolbar, &ToolBar::settingsClicked, &gui.settings_dialog, &Settings::requestAll);
+        QObject::connect(&gui.toolbar, &ToolBar::settingsClicked, &gui.settings_dialog, &Settings::show);
 
-        // Connections: Settings --> Radar
+        // Connections: Settings --> Radar, the slots only queue the command for the acquisition thread
         qRegisterMetaType<Frame_Format_t>("Frame_Format_t");
-        QObject::connect(&settings_dialog, &Settings::requestFrameFormat, &radar, &Radar::getFrameFormat, Qt::DirectConnection);
-        QObject::connect(&settings_dialog, &Settings::frameFormatChanged, &radar, &Radar::setFrameFormat, Qt::DirectConnection);
+        QObject::connect(&gui.settings_dialog, &Settings::requestFrameFormat, radar, &Radar::getFrameFormat, Qt::DirectConnection);
+        QObject::connect(&gui.settings_dialog, &Settings::frameFormatChanged, radar, &Radar::setFrameFormat, Qt::DirectConnection);
         qRegisterMetaType<DSP_Settings_t>("DSP_Settings_t");
-        QObject::connect(&settings_dialog, &Settings::requestDspSettings, &radar, &Radar::getDspSettings, Qt::DirectConnection);
-        QObject::connect(&settings_dialog, &Settings::dspSettingsChanged, &radar, &Radar::setDspSettings, Qt::DirectConnection);
+        QObject::connect(&gui.settings_dialog, &Settings::requestDspSettings, radar, &Radar::getDspSettings, Qt::DirectConnection);
+        QObject::connect(&gui.settings_dialog, &Settings::dspSettingsChanged, radar, &Radar::setDspSettings, Qt::DirectConnection);
 
         // Connections: Radar --> Settings
-        QObject::connect(&radar, &Radar::frameFormatChanged, &settings_dialog, &Settings::responseFrameFormat);
-        QObject::connect(&radar, &Radar::dspSettingsChanged, &settings_dialog, &Settings::responseDspSettings);
+        QObject::connect(radar, &Radar::frameFormatChanged, &gui.settings_dialog, &Settings::responseFrameFormat);
+        QObject::connect(radar, &Radar::dspSettingsChanged, &gui.settings_dialog, &Settings::responseDspSettings);
+    }
+
+    gui.dashboard.setPlot(&gui.timedata, ChartType_t::TimeData);
+    gui.dashboard.setPlot(&gui.rangedata, ChartType_t::RangeData);
+    gui.targetdata.setHeatmapSettings(settings.heatmap_settings);
+    gui.dashboard.setChart(&gui.targetdata, ChartType_t::TargetData);
+    if (settings.waterfall_settings.enabled)
+    {
+        gui.waterfall.setSettings(settings.waterfall_settings);
+        gui.dashboard.setPlot(&gui.waterfall, ChartType_t::Waterfall);
+        gui.updater.setWaterfall(&gui.waterfall);
+    }
+
+    // Connections: Pipeline --> Chart updater --> Charts, at the refresh rate of the screen
+    QObject::connect(&pipeline, &Pipeline::timeDataChanged, &gui.updater, &ChartUpdater::updateTimeData, Qt::DirectConnection);
+    QObject::connect(&pipeline, &Pipeline::rangeDataChanged, &gui.updater, &ChartUpdater::updateRangeData, Qt::DirectConnection);
+    QObject::connect(&pipeline, &Pipeline::targetDataChanged, &gui.updater, &ChartUpdater::updateTargetData, Qt::DirectConnection);
+    gui.updater.start();
+
+    // The charts only ask for data while the dashboard is shown, a minimized kiosk skips their processing
+    QVector<int> consumers = {
+        pipeline.addConsumer(PIPELINE_STAGE_TIME_DATA),
+        pipeline.addConsumer(PIPELINE_STAGE_RANGE_DATA | PIPELINE_STAGE_MAXIMA),
+        pipeline.addConsumer(PIPELINE_STAGE_TARGETS)
+    };
+    if (settings.waterfall_settings.enabled)
+        consumers.append(pipeline.addConsumer(PIPELINE_STAGE_RANGE_DATA));
+
+    for (auto consumer : consumers)
+        pipeline.setConsumerActive(consumer, false);
+
+    QObject::connect(&gui.dashboard, &Dashboard::shownChanged, [&pipeline, consumers](bool shown) {
+        for (auto consumer : consumers)
+            pipeline.setConsumerActive(consumer, shown);
+    });
+
+    // Connections: Timeline --> Chart updater, History player --> Charts
+    if (history != nullptr)
+    {
+        gui.timeline.setHistory(history);
+        gui.player.setSignalProcessorSettings(settings.signal_processor_settings);
+        gui.dashboard.setTimeline(&gui.timeline);
+
+        QObject::connect(&gui.timeline, &Timeline::pausedChanged, &gui.updater, &ChartUpdater::setPaused);
+        QObject::connect(&gui.timeline, &Timeline::pausedChanged, &gui.targetdata, &TargetDataChart::setPaused);
+        QObject::connect(&gui.timeline, &Timeline::frameSelected, &gui.player, &HistoryPlayer::showFrame);
+        QObject::connect(&gui.player, &HistoryPlayer::timeDataChanged, &gui.timedata, &TimeDataChart::setData);
+        QObject::connect(&gui.player, &HistoryPlayer::targetDataChanged, &gui.targetdata, &TargetDataChart::update);
+
+        // Without a timestamp, browsed frames don't count as rendered frames nor into the end-to-end latency
+        QObject::connect(&gui.player, &HistoryPlayer::rangeDataChanged, &gui.rangedata,
+                         [&gui](DataPoints_t const & rx1, DataPoints_t const & rx2, DataPoints_t const & maxima, double const & max_y) {
+            gui.rangedata.setData(rx1, rx2, maxima, max_y, 0);
+        });
     }
 
-    dashboard.setChart(&timedata, ChartType_t::TimeData);
-    dashboard.setChart(&rangedata, ChartType_t::RangeData);
-    dashboard.setChart(&targetdata, ChartType_t::TargetData);
+    // Performance overlay, F12 toggles it
+    gui.dashboard.setHud(&gui.hud);
+    gui.hud.setVisible(settings.hud_settings.enabled);
+    auto hud_shortcut = new QShortcut(QKeySequence(Qt::Key_F12), &gui.dashboard);
+    QObject::connect(hud_shortcut, &QShortcut::activated, &gui.hud, [&gui]() { gui.hud.setVisible(!gui.hud.isVisible()); });
+
+#ifdef _WIN32
+    // Connections: Dashboard --> Frame source
+    QObject::connect(&gui.dashboard, &Dashboard::closed, source, &FrameSource::stop, Qt::DirectConnection);
+#endif
+}
+
+void setupHeadless(JsonLineSink & sink, FrameSource * source, Pipeline & pipeline)
+{
+    // Connections: Frame source, Pipeline --> Sink
+    QObject::connect(source, &FrameSource::connectionChanged, &sink, &JsonLineSink::updateConnection);
+    QObject::connect(&pipeline, &Pipeline::rangeDataChanged, &sink, &JsonLineSink::updateRangeData);
+    QObject::connect(&pipeline, &Pipeline::targetDataChanged, &sink, &JsonLineSink::updateTargetData);
+    pipeline.addConsumer(PIPELINE_STAGE_MAXIMA | PIPELINE_STAGE_TARGETS);
+
+    // Without a window to close, the application ends with the frame source
+    QObject::connect(source, &FrameSource::finished, QCoreApplication::instance(), &QCoreApplication::quit, Qt::QueuedConnection);
+}
+
+
+int main(int argc, char *argv[])
+{
+    // Register the message handler within the application
+    qInstallMessageHandler(messageHandler);
+
+    // Headless mode has to be known before the application is instantiated, as it runs without QtWidgets
+    auto headless = isHeadless(argc, argv);
+    QScopedPointer<QCoreApplication> a(headless ? new QCoreApplication(argc, argv) : new QApplication(argc, argv));
+
+    // Command line options: without any of them the radar sensor is used as frame source
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Dashboard for the Infineon Position2Go radar sensor");
+    parser.addHelpOption();
+    parser.addOption({"replay", "Replay frames from a recording instead of the radar sensor.", "file"});
+    parser.addOption({"speed", "Replay speed factor: 1 = real time, 0 = as fast as possible.", "factor", QString::number(REPLAY_SPEED_REALTIME)});
+    parser.addOption({"start", "Start the replay at the given offset in seconds.", "seconds", "0"});
+    parser.addOption({"synthetic", "Generate synthetic frames instead of using the radar sensor."});
+    parser.addOption({"record", "Record raw frames and targets into a file.", "file"});
+    parser.addOption({"stream", "Stream frames, range data, maxima and targets to local clients."});
+    parser.addOption({"shm", "Publish frames, range data, maxima and targets into a shared memory ring."});
+    parser.addOption({"headless", "Run without gui and write results as JSON lines into the sink."});
+    parser.addOption({"sink", "Result sink in headless mode, - for stdout.", "file", "-"});
+    parser.addOption({"latency", "Measure the latency of every processing stage, logged at exit and on SIGUSR1."});
+    parser.addOption({"metrics", "Serve counters, gauges and stage latencies for Prometheus on /metrics."});
+    parser.addOption({"trace", "Trace the processing stages, the last seconds are written as Chrome trace on Ctrl+T, SIGUSR2 and at exit.", "file"});
+    parser.process(*a);
+
+    // The results may be written to stdout in headless mode, so no message must ever go there
+    AsyncLogger::instance().setStderrOnly(headless && JsonLineSink::isStdoutPath(parser.value("sink")));
+
+    // Signal watch for linux to catch all kinds of termination, so the radar can get into a defined state
+#ifdef __linux__
+    UnixSignalWatcher sigwatch;
+    sigwatch.watchForSignal(SIGINT);
+    sigwatch.watchForSignal(SIGTERM);
+    sigwatch.watchForSignal(SIGQUIT);
+    sigwatch.watchForSignal(SIGHUP);
+    if (parser.isSet("latency"))
+        sigwatch.watchForSignal(SIGUSR1);
+    if (parser.isSet("trace"))
+        sigwatch.watchForSignal(SIGUSR2);
+    QObject::connect(&sigwatch, &UnixSignalWatcher::unixSignal, a.data(), [&parser](int signal) {
+        if (signal == SIGUSR1)
+            logLatencyMetrics();
+        else if (signal == SIGUSR2)
+            dumpTrace(parser.value("trace"));
+        else
+            QCoreApplication::quit();
+    });
+#endif
+
+    // Instantiate all variables
+    Settings_t settings;
+    QJsonObject settings_json;
+    SettingsWatcher settings_watcher;
+    Pipeline pipeline;
+    RecordingWriter recorder;
+    StreamServer stream_server;
+    SharedMemoryRing shared_memory_ring;
+    HistoryRing history;
+    MetricsServer metrics_server;
+    QScopedPointer<FrameSource> source(createFrameSource(parser));
+    auto radar = qobject_cast<Radar*>(source.data());
+    QScopedPointer<Gui_t> gui;
+    JsonLineSink sink;
+
+    // Latency metrics, end-to-end only for live sources as replays carry their recorded timestamps
+    auto & latency_metrics = LatencyMetrics::instance();
+    latency_metrics.setEnabled(parser.isSet("latency") || parser.isSet("metrics"));
+    latency_metrics.setEndToEndEnabled(!parser.isSet("replay"));
+    QTimer latency_timer;
+
+    // Load Settings
+    if (!tryParsingSettings(settings, settings_json))
+    {
+        return ERROR_STARTUP_PARSING_CONFIGURATION_FAILED;
+    }
+
+    // From now on messages are written by the logger thread
+    settings.logging_settings.stderr_only = AsyncLogger::instance().isStderrOnly();
+    AsyncLogger::instance().start(settings.logging_settings);
+
+    // Trace recorder, its settings have to be set before any thread records
+    auto & trace = TraceRecorder::instance();
+    trace.setSettings(settings.trace_settings);
+    trace.setEnabled(parser.isSet("trace"));
+    trace.setThreadName("Main");
 
-    // Connections: Radar --> Charts
     qRegisterMetaType<Targets_t>("Targets_t");
     qRegisterMetaType<DataPoints_t>("DataPoints_t");
-    QObject::connect(&radar, &Radar::timeDataChanged, &timedata, &TimeDataChart::update);
-    QObject::connect(&radar, &Radar::rangeDataChanged, &rangedata, &RangeDataChart::update);
-    QObject::connect(&radar, &Radar::targetDataChanged, &targetdata, &TargetDataChart::update);
 
-    // Try to setup the radar sensor
-    if (!tryConnect(radar))
+    // Setup either the dashboard or the headless result sink
+    if (headless)
+    {
+        if (!tryOpeningSink(sink, parser.value("sink")))
+        {
+            return ERROR_STARTUP_OPENING_SINK_FAILED;
+        }
+        Q_ASSERT(!sink.isStdout() || AsyncLogger::instance().isStderrOnly());
+        setupHeadless(sink, source.data(), pipeline);
+    }
+    else
+    {
+        gui.reset(new Gui_t);
+
+        // The history is only kept for browsing it in the dashboard
+        auto history_enabled = settings.history_settings.memory > 0 && history.open(settings.history_settings);
+        if (history_enabled)
+        {
+            pipeline.setHistory(&history);
+        }
+        setupDashboard(*gui, settings, source.data(), radar, pipeline, history_enabled ? &history : nullptr);
+
+        // Connections: Latency metrics --> Statusbar
+        if (latency_metrics.isEnabled() && settings.statusbar_enabled)
+        {
+            QObject::connect(&latency_timer, &QTimer::timeout, &gui->statusbar, [&gui, &latency_metrics]() {
+                gui->statusbar.updateLatency(latency_metrics.summary(), "<pre>" + latency_metrics.dump().toHtmlEscaped() + "</pre>");
+            });
+            latency_timer.start(LATENCY_STATUSBAR_UPDATE_INTERVAL);
+        }
+
+        // Connections: Shortcut --> Trace recorder
+        if (trace.isEnabled())
+        {
+            auto shortcut = new QShortcut(QKeySequence("Ctrl+T"), &gui->dashboard);
+            QObject::connect(shortcut, &QShortcut::activated, [&parser]() { dumpTrace(parser.value("trace")); });
+        }
+    }
+
+    // Frame source --> Pipeline --> Recorder, Stream server, Shared memory, Metrics server
+    pipeline.setSignalProcessorSettings(settings.signal_processor_settings);
+    source->setPipeline(&pipeline);
+    if (parser.isSet("record") && recorder.open(parser.value("record"), settings.recording_settings))
     {
-        return ERROR_STARTUP_CONNECTION_FAILED;
+        pipeline.setRecorder(&recorder);
     }
-    if (!tryAddingEndpoints(radar))
+    if (parser.isSet("stream") && stream_server.open(settings.streaming_settings))
     {
-        return ERROR_STARTUP_ADDING_ENDPOINTS_FAILED;
+        pipeline.setStreamServer(&stream_server);
     }
-    if (!trySettingUpFrameTrigger(radar))
+    if (parser.isSet("shm") && shared_memory_ring.open(settings.shared_memory_settings))
     {
-        return ERROR_STARTUP_FRAMETRIGGER_SETUP_FAILED;
+        pipeline.setSharedMemoryRing(&shared_memory_ring);
+    }
+    if (parser.isSet("metrics") && metrics_server.open(settings.metrics_settings))
+    {
+        metrics_server.setRecorder(&recorder);
+        metrics_server.setStreamServer(&stream_server);
     }
 
-    // Set the parsed dsp settings
-    radar.setDspSettings(settings.dsp_settings);
+    if (radar != nullptr)
+    {
+        // Try to setup the radar sensor
+        if (!tryConnect(*radar))
+        {
+            return ERROR_STARTUP_CONNECTION_FAILED;
+        }
+        if (!tryAddingEndpoints(*radar))
+        {
+            return ERROR_STARTUP_ADDING_ENDPOINTS_FAILED;
+        }
+        if (!trySettingUpFrameTrigger(*radar))
+        {
+            return ERROR_STARTUP_FRAMETRIGGER_SETUP_FAILED;
+        }
+
+        // Queue the parsed dsp settings, they are sent with the first measurement cycle
+        radar->setDspSettings(settings.dsp_settings);
+    }
 
-    // Move the radar object into another thread, so the main thread with the gui won't block
-    QThread* thread = new QThread();
-    radar.moveToThread(thread);
+    // Connections: Settings watcher --> Radar, Pipeline, Charts, applied without interrupting the frames
+    if (settings_watcher.watch(CONFIGURATION_FILE_PATH, settings_json))
+    {
+        if (radar != nullptr)
+            QObject::connect(&settings_watcher, &SettingsWatcher::dspSettingsChanged, radar, &Radar::setDspSettings, Qt::DirectConnection);
+
+        QObject::connect(&settings_watcher, &SettingsWatcher::signalProcessorSettingsChanged, &pipeline, &Pipeline::setSignalProcessorSettings);
+
+        if (gui)
+        {
+            QObject::connect(&settings_watcher, &SettingsWatcher::signalProcessorSettingsChanged, &gui->player, &HistoryPlayer::setSignalProcessorSettings);
+            QObject::connect(&settings_watcher, &SettingsWatcher::heatmapSettingsChanged, &gui->targetdata, &TargetDataChart::setHeatmapSettings);
+            QObject::connect(&settings_watcher, &SettingsWatcher::hudSettingsChanged, &gui->hud, [&gui](HudSettings_t const & hud_settings) {
+                gui->hud.setVisible(hud_settings.enabled);
+            });
+
+            // The settings dialog asks the sensor again, its commands are queued behind the new settings
+            if (radar != nullptr && settings.toolbar_enabled)
+                QObject::connect(&settings_watcher, &SettingsWatcher::dspSettingsChanged, &gui->settings_dialog, &Settings::requestAll);
+        }
+    }
 
-    // Connections: Thread --> Radar
-    QObject::connect(thread, &QThread::started, &radar, &Radar::doMeasurement);
+    auto replay = qobject_cast<ReplaySource*>(source.data());
+    if (replay != nullptr && !tryOpeningReplay(*replay, parser.value("replay"), parser.value("speed").toDouble(), parser.value("start").toDouble()))
+    {
+        return ERROR_STARTUP_OPENING_REPLAY_FAILED;
+    }
 
-#ifdef _WIN32
-    // Connections: Dashboard --> Radar
-    QObject::connect(&dashboard, &Dashboard::closed, &radar, &Radar::disconnect, Qt::DirectConnection);
-#endif
+    // Move the frame source into another thread, so the main thread with the gui or sink won't block
+    QThread* thread = new QThread();
+    source->moveToThread(thread);
+
+    // Connections: Thread --> Frame source
+    QObject::connect(thread, &QThread::started, []() { TraceRecorder::instance().setThreadName("Acquisition"); });
+    QObject::connect(thread, &QThread::started, source.data(), &FrameSource::run);
 
     // Start the thread
     thread->start();
 
     // Main thread execution continues...
-    dashboard.show();
+    if (gui)
+    {
+        gui->dashboard.show();
+    }
 
 #ifdef __linux__
-    auto ret = a.exec();
-    radar.disconnect();
-    return ret;
+    auto ret = a->exec();
+    source->stop();
 #elif _WIN32
-    return a.exec();
+    auto ret = a->exec();
 #endif
+
+    thread->quit();
+    thread->wait();
+    recorder.close();
+    metrics_server.close();
+    stream_server.close();
+    shared_memory_ring.close();
+
+    if (latency_metrics.isEnabled())
+        logLatencyMetrics();
+
+    if (trace.isEnabled())
+        dumpTrace(parser.value("trace"));
+
+    AsyncLogger::instance().stop();
+
+    return ret;
 }
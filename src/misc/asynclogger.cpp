@@ -0,0 +1,328 @@
+#include "asynclogger.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QThread>
+#include <cstdio>
+
+// Constants
+constexpr auto LOGGER_IDLE_WAIT = 10;
+constexpr auto LOGGER_MAX_BATCH = 256;
+constexpr auto LOGGER_FATAL_DRAIN_TIMEOUT = 100;
+
+// QtMsgType isn't ordered by severity
+static int severity(QtMsgType type)
+{
+    switch (type)
+    {
+        case QtDebugMsg: return 0;
+        case QtInfoMsg: return 1;
+        case QtWarningMsg: return 2;
+        case QtCriticalMsg: return 3;
+        case QtFatalMsg: return 4;
+    }
+    return 0;
+}
+
+AsyncLogger::AsyncLogger()
+{
+    m_thread = nullptr;
+    m_running = false;
+    m_shutdown = false;
+    m_stderr_only = false;
+    m_dropped = 0;
+    m_rate_limit = 0;
+    m_file = nullptr;
+
+    for (auto & r : m_rate_limits)
+    {
+        r.second = 0;
+        r.count = 0;
+        r.suppressed = 0;
+    }
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    stop();
+}
+
+AsyncLogger & AsyncLogger::instance()
+{
+    static AsyncLogger logger;
+    return logger;
+}
+
+bool AsyncLogger::start(const LoggingSettings_t &settings)
+{
+    if (m_thread != nullptr)
+        return false;
+
+    if (!settings.file.isEmpty())
+    {
+        m_file = fopen(settings.file.toLocal8Bit().constData(), "a");
+        if (m_file == nullptr)
+        {
+            qWarning() << "Error while opening log file" << settings.file;
+            return false;
+        }
+    }
+
+    // Levels are filtered by Qt before a message is formatted, categorized messages cost nothing then
+    QLoggingCategory::setFilterRules(filterRules(settings));
+
+    m_stderr_only = m_stderr_only || settings.stderr_only;
+    m_rate_limit = settings.rate_limit;
+    // The queue is never freed before the destructor, a producer may still push right after stop()
+    if (!m_queue)
+        m_queue.reset(new MpscQueue<LogRecord_t>(settings.queue_capacity));
+    m_shutdown = false;
+    m_thread = QThread::create([this]() { writerLoop(); });
+    m_thread->setObjectName("AsyncLogger");
+    m_thread->start();
+    m_running = true;
+
+    return true;
+}
+
+void AsyncLogger::stop()
+{
+    if (m_thread == nullptr)
+        return;
+
+    // The writer thread drains the queue before it quits
+    m_running = false;
+    m_shutdown = true;
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+
+    if (m_file != nullptr)
+    {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void AsyncLogger::setStderrOnly(bool stderr_only)
+{
+    m_stderr_only = stderr_only;
+}
+
+bool AsyncLogger::isStderrOnly() const
+{
+    return m_stderr_only;
+}
+
+void AsyncLogger::log(QtMsgType type, const char *category, const QString &msg)
+{
+    LogRecord_t record;
+    record.timestamp_ms = QDateTime::currentMSecsSinceEpoch();
+    record.type = type;
+    record.stderr_only = m_stderr_only;
+
+    if (!m_running.load(std::memory_order_acquire))
+    {
+        record.text = msg.toUtf8();
+        writeDirectly(record);
+        return;
+    }
+
+    if (type == QtFatalMsg)
+    {
+        // The application aborts after the handler returns, so everything queued is written first
+        QElapsedTimer timer;
+        timer.start();
+        while (!m_queue->isEmpty() && timer.elapsed() < LOGGER_FATAL_DRAIN_TIMEOUT)
+            QThread::msleep(1);
+
+        record.text = msg.toUtf8();
+        writeDirectly(record);
+        return;
+    }
+
+    if (!passesRateLimit(type, category, record.timestamp_ms))
+        return;
+
+    record.text = msg.toUtf8();
+    if (!m_queue->tryPush(std::move(record)))
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool AsyncLogger::levelFromName(const QString &name, QtMsgType &level)
+{
+    auto n = name.toLower();
+    if (n == "debug")
+        level = QtDebugMsg;
+    else if (n == "info")
+        level = QtInfoMsg;
+    else if (n == "warning")
+        level = QtWarningMsg;
+    else if (n == "critical")
+        level = QtCriticalMsg;
+    else
+        return false;
+
+    return true;
+}
+
+bool AsyncLogger::passesRateLimit(QtMsgType type, const char *category, qint64 timestamp_ms)
+{
+    if (m_rate_limit == 0)
+        return true;
+
+    // Slots are shared by categories with the same hash, which only makes the limit stricter
+    auto & r = m_rate_limits[(qHash(QByteArray::fromRawData(category, qstrlen(category))) ^ type) % RATE_LIMIT_SLOTS];
+    auto second = timestamp_ms / 1000;
+
+    auto previous = r.second.load(std::memory_order_relaxed);
+    if (previous != second && r.second.compare_exchange_strong(previous, second, std::memory_order_relaxed))
+    {
+        r.count.store(0, std::memory_order_relaxed);
+
+        auto suppressed = r.suppressed.exchange(0, std::memory_order_relaxed);
+        if (suppressed > 0)
+        {
+            LogRecord_t record;
+            record.timestamp_ms = timestamp_ms;
+            record.type = QtWarningMsg;
+            record.stderr_only = m_stderr_only;
+            record.text = QString("%1 message(s) of category %2 suppressed by the rate limit.").arg(suppressed).arg(category).toUtf8();
+            if (!m_queue->tryPush(std::move(record)))
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (r.count.fetch_add(1, std::memory_order_relaxed) < m_rate_limit)
+        return true;
+
+    r.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void AsyncLogger::writerLoop()
+{
+    quint64 reported_drops = 0;
+    LogRecord_t record;
+
+    while (true)
+    {
+        auto count = 0;
+        while (count < LOGGER_MAX_BATCH && m_queue->tryPop(record))
+        {
+            write(record);
+            count++;
+        }
+
+        auto drops = m_dropped.load(std::memory_order_relaxed);
+        if (drops != reported_drops)
+        {
+            LogRecord_t warning;
+            warning.timestamp_ms = QDateTime::currentMSecsSinceEpoch();
+            warning.type = QtWarningMsg;
+            warning.stderr_only = m_stderr_only;
+            warning.text = QString("Logger can't keep up: %1 message(s) dropped.").arg(drops - reported_drops).toUtf8();
+            write(warning);
+            reported_drops = drops;
+        }
+
+        flush();
+
+        if (count == 0)
+        {
+            if (m_shutdown)
+                break;
+
+            QThread::msleep(LOGGER_IDLE_WAIT);
+        }
+    }
+}
+
+void AsyncLogger::write(const LogRecord_t &record)
+{
+    auto s = stream(record);
+    if (s == stdout)
+        m_stdout_batch.append(format(record));
+    else if (s == stderr)
+        m_stderr_batch.append(format(record));
+    else
+        fputs(format(record).constData(), s);
+}
+
+void AsyncLogger::writeDirectly(const LogRecord_t &record)
+{
+    auto s = stream(record);
+    fputs(format(record).constData(), s);
+    fflush(s);
+}
+
+void AsyncLogger::flush()
+{
+    if (!m_stdout_batch.isEmpty())
+    {
+        fwrite(m_stdout_batch.constData(), 1, m_stdout_batch.size(), stdout);
+        fflush(stdout);
+        m_stdout_batch.clear();
+    }
+
+    if (!m_stderr_batch.isEmpty())
+    {
+        fwrite(m_stderr_batch.constData(), 1, m_stderr_batch.size(), stderr);
+        fflush(stderr);
+        m_stderr_batch.clear();
+    }
+
+    if (m_file != nullptr)
+        fflush(m_file);
+}
+
+FILE *AsyncLogger::stream(const LogRecord_t &record) const
+{
+    if (m_file != nullptr && m_running)
+        return m_file;
+
+    if (record.type == QtDebugMsg || record.type == QtInfoMsg)
+        return record.stderr_only ? stderr : stdout;
+
+    return stderr;
+}
+
+QString AsyncLogger::filterRules(const LoggingSettings_t &settings)
+{
+    static const QtMsgType levels[] = {QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg};
+    static const char * names[] = {"debug", "info", "warning", "critical"};
+
+    // Rules are applied in order, so the categories override the general level
+    auto rules = [](QString const & category, QtMsgType level) {
+        QString r;
+        for (auto i = 0; i < 4; i++)
+        {
+            auto enabled = severity(levels[i]) >= severity(level);
+            r.append(QString("%1.%2=%3\n").arg(category).arg(names[i]).arg(enabled ? "true" : "false"));
+        }
+        return r;
+    };
+
+    auto result = rules("*", settings.level);
+    for (auto it = settings.categories.begin(); it != settings.categories.end(); it++)
+        result.append(rules(it.key(), it.value()));
+
+    return result;
+}
+
+QByteArray AsyncLogger::format(const LogRecord_t &record)
+{
+    char const * level = "";
+    switch (record.type)
+    {
+        case QtDebugMsg: level = "DEBUG"; break;
+        case QtInfoMsg: level = "INFO"; break;
+        case QtWarningMsg: level = "WARNING"; break;
+        case QtCriticalMsg: level = "CRITICAL"; break;
+        case QtFatalMsg: level = "FATAL"; break;
+    }
+
+    auto time = QDateTime::fromMSecsSinceEpoch(record.timestamp_ms).time().toString().toUtf8();
+    return time + " [" + level + "]: " + record.text + "\n";
+}
@@ -0,0 +1,93 @@
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <misc/mpscqueue.h>
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <memory>
+
+class QThread;
+
+struct LoggingSettings_t
+{
+    QString file;                           // Empty for stdout and stderr
+    QtMsgType level;                        // Lowest level of all categories
+    QMap<QString, QtMsgType> categories;    // Lowest level of single categories, e.g. p2g.radar
+    quint32 rate_limit;                     // Messages per second and category, 0 disables the limit
+    quint32 queue_capacity;                 // Messages buffered for the writer thread
+    bool stderr_only;                       // See AsyncLogger::setStderrOnly()
+};
+
+struct LogRecord_t
+{
+    qint64 timestamp_ms;
+    QtMsgType type;
+    bool stderr_only;       // Taken when the message is logged, so a later switch doesn't move queued records
+    QByteArray text;
+};
+
+// Message handler backend: producers only move the message into a lock-free ring, a writer thread
+// formats the records and writes them in batches with one flush per batch. Until start() and after
+// stop(), messages are written directly by the calling thread.
+class AsyncLogger
+{
+public:
+    static AsyncLogger & instance();
+    ~AsyncLogger();
+
+    bool start(LoggingSettings_t const & settings);
+    void stop();
+
+    // Set when stdout carries data, e.g. the result sink in headless mode, so all messages go to stderr.
+    // Has to be set before the first message, as soon as the command line is known.
+    void setStderrOnly(bool stderr_only);
+    bool isStderrOnly() const;
+
+    void log(QtMsgType type, char const * category, QString const & msg);
+
+    static bool levelFromName(QString const & name, QtMsgType & level);
+
+private:
+    struct RateLimit_t
+    {
+        std::atomic<qint64> second;
+        std::atomic<quint32> count;
+        std::atomic<quint32> suppressed;
+    };
+
+    AsyncLogger();
+    bool passesRateLimit(QtMsgType type, char const * category, qint64 timestamp_ms);
+    void writerLoop();
+    void write(LogRecord_t const & record);
+    void writeDirectly(LogRecord_t const & record);
+    void flush();
+    FILE * stream(LogRecord_t const & record) const;
+
+    static QString filterRules(LoggingSettings_t const & settings);
+    static QByteArray format(LogRecord_t const & record);
+
+private:
+    static constexpr size_t RATE_LIMIT_SLOTS = 64;
+
+    // Shared between all threads
+    std::unique_ptr<MpscQueue<LogRecord_t>> m_queue;
+    QThread *m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_shutdown;
+    std::atomic<bool> m_stderr_only;
+    std::atomic<quint64> m_dropped;
+    std::array<RateLimit_t, RATE_LIMIT_SLOTS> m_rate_limits;
+    quint32 m_rate_limit;
+
+    // Writer thread
+    FILE *m_file;
+    QByteArray m_stdout_batch;
+    QByteArray m_stderr_batch;
+};
+
+#endif // ASYNCLOGGER_H
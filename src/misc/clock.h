@@ -0,0 +1,13 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <QtGlobal>
+#include <chrono>
+
+// Host monotonic time in nanoseconds, unaffected by changes of the wall clock
+inline qint64 monotonicTimestamp()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // CLOCK_H
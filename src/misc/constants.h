@@ -5,14 +5,43 @@ constexpr auto ERROR_STARTUP_CONNECTION_FAILED = -1;
 constexpr auto ERROR_STARTUP_ADDING_ENDPOINTS_FAILED = -2;
 constexpr auto ERROR_STARTUP_FRAMETRIGGER_SETUP_FAILED = -3;
 constexpr auto ERROR_STARTUP_PARSING_CONFIGURATION_FAILED = -4;
+constexpr auto ERROR_STARTUP_OPENING_REPLAY_FAILED = -5;
+constexpr auto ERROR_BATCH_INVALID_ARGUMENTS = -6;
+constexpr auto ERROR_BATCH_PROCESSING_FAILED = -7;
+constexpr auto ERROR_STARTUP_OPENING_SINK_FAILED = -8;
 
-constexpr auto STARTUP_CONNECTION_ATTEMPS = 5;
-constexpr auto STARTUP_CONNECTION_PAUSE_TIME = 500;
+constexpr auto STARTUP_CONNECTION_ATTEMPS = 25;
+constexpr auto STARTUP_CONNECTION_PAUSE_TIME = 100;
 
 constexpr auto RADAR_MEASUREMENT_PAUSE_TIME = 100;
+constexpr auto RADAR_COMMAND_QUEUE_CAPACITY = 64;
 
 constexpr auto RADAR_EXPECTED_FIRMWARE_VERSION = "1.1.0";
+constexpr auto RADAR_USB_VENDOR_ID = 0x058b;
+constexpr auto RADAR_USB_PRODUCT_ID = 0x0058;
+
+constexpr auto RADAR_SAMPLING_FREQUENCY = 213.34 * 1e3;
+constexpr auto RADAR_RAMP_TIME_EFF = 300 * 1e-6;
+constexpr auto RADAR_BANDWITH_EFF = 200 * 1e6;
+constexpr auto SPEED_OF_LIGHT = 3 * 1e8;
+
+constexpr auto SIGNAL_DEFAULT_ZERO_PADDING_FACTOR = 4u;
+constexpr auto SIGNAL_DEFAULT_PERSISTENCE_THRESHOLD = 0.01;
+constexpr auto SIGNAL_DEFAULT_CFAR_THRESHOLD_FACTOR = 3.0;
+
+constexpr auto REPLAY_SPEED_REALTIME = 1.0;
+constexpr auto REPLAY_SPEED_UNTHROTTLED = 0.0;
+
+constexpr auto SYNTHETIC_FRAME_INTERVAL = RADAR_MEASUREMENT_PAUSE_TIME;
+constexpr auto SYNTHETIC_SAMPLES_PER_CHIRP = 64;
+
+constexpr auto BATCH_DEFAULT_SHARD_SIZE = 256;
+constexpr auto BATCH_SHARDS_IN_FLIGHT_PER_THREAD = 4;
+constexpr auto SWEEP_DEFAULT_MATCH_TOLERANCE = 0.25;
+
+constexpr auto LATENCY_STATUSBAR_UPDATE_INTERVAL = 1000;
 
 constexpr auto CONFIGURATION_FILE_PATH = "./config.json";
+constexpr auto LAST_PORT_FILE_PATH = "./.p2g-last-port";
 
 #endif // CONSTANTS_H
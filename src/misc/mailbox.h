@@ -0,0 +1,51 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <atomic>
+
+// Latest-value mailbox for one producer and one consumer thread, implemented as a triple buffer:
+// the producer writes into its own slot and swaps it with the shared one, the consumer swaps the shared
+// slot with its own when it holds a new value. Values the consumer didn't take in time are overwritten.
+// Neither side ever blocks.
+template <typename T>
+class Mailbox
+{
+public:
+    Mailbox()
+    {
+        m_back = 0;
+        m_shared = 1;
+        m_front = 2;
+    }
+
+    // Producer: returns false if the previous value wasn't taken and got overwritten
+    bool put(T const & value)
+    {
+        m_slots[m_back] = value;
+        auto previous = m_shared.exchange(m_back | NEW_VALUE, std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+        return (previous & NEW_VALUE) == 0;
+    }
+
+    // Consumer: returns the newest value or nullptr if there is none since the last call
+    T const * take()
+    {
+        if ((m_shared.load(std::memory_order_relaxed) & NEW_VALUE) == 0)
+            return nullptr;
+
+        auto previous = m_shared.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return &m_slots[m_front];
+    }
+
+private:
+    static constexpr unsigned INDEX_MASK = 3;
+    static constexpr unsigned NEW_VALUE = 4;
+
+    T m_slots[3];
+    unsigned m_back;                    // Producer
+    alignas(64) std::atomic<unsigned> m_shared;
+    alignas(64) unsigned m_front;       // Consumer
+};
+
+#endif // MAILBOX_H
@@ -0,0 +1,94 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for any number of producer threads and exactly one consumer thread.
+// Every slot carries a sequence number, which tells producers and the consumer whether the slot is
+// free or filled in the current round, so producers only contend on the tail index.
+template <typename T>
+class MpscQueue
+{
+public:
+    explicit MpscQueue(size_t capacity = 1024)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        m_slots = std::vector<Slot_t>(size);
+        for (size_t i = 0; i < size; i++)
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+
+        m_mask = size - 1;
+        m_head = 0;
+        m_tail = 0;
+    }
+
+    // Producer: moves the value into the queue, false if the queue is full
+    bool tryPush(T && value)
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto & slot = m_slots[tail & m_mask];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(tail);
+
+            if (diff == 0)
+            {
+                if (m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+                {
+                    slot.value = std::move(value);
+                    slot.sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                tail = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer: moves the oldest value out of the queue, false if the queue is empty
+    bool tryPop(T & value)
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        auto & slot = m_slots[head & m_mask];
+
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+            return false;
+
+        value = std::move(slot.value);
+        slot.sequence.store(head + m_mask + 1, std::memory_order_release);
+        m_head.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Only a snapshot
+    bool isEmpty() const
+    {
+        return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot_t
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::vector<Slot_t> m_slots;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,83 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer and one consumer thread.
+// Slots are preallocated and filled in place: the producer acquires a slot, fills it and commits it,
+// the consumer reads the front slot and pops it. Neither side ever allocates or blocks.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity = 1024)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+
+        m_slots.resize(size);
+        m_mask = size - 1;
+        m_head = 0;
+        m_tail = 0;
+    }
+
+    // Producer: returns the next free slot or nullptr if the queue is full
+    T * acquire()
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+            return nullptr;
+
+        return &m_slots[tail & m_mask];
+    }
+
+    // Producer: publishes the slot returned by acquire()
+    void commit()
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer: returns the oldest published slot or nullptr if the queue is empty
+    T * front()
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return nullptr;
+
+        return &m_slots[head & m_mask];
+    }
+
+    // Consumer: releases the slot returned by front()
+    void pop()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Only a snapshot, if called by neither the producer nor the consumer
+    size_t size() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+    // Only safe while neither producer nor consumer are active
+    std::vector<T> & slots()
+    {
+        return m_slots;
+    }
+
+private:
+    std::vector<T> m_slots;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+};
+
+#endif // SPSCQUEUE_H
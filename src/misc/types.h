@@ -19,7 +19,8 @@ enum class ChartType_t
 {
     TimeData,
     RangeData,
-    TargetData
+    TargetData,
+    Waterfall
 };
 
 enum class EndpointType_t